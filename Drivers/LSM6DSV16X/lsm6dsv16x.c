@@ -3,15 +3,16 @@
 
 #include "ti_msp_dl_config.h"
 #include "clock.h"
+#include "i2c_bus.h"
+#include "fast_math.h"
 #include "string.h"
 
 #define BOOT_TIME         (10)
-#define I2C_TIMEOUT_MS    (10)
-#define RAD_TO_DEG        (180.0f / M_PI)
 
 #define LSM6DSV16X_ADDR   (0x6A)
 
 static uint8_t whoamI;
+static const I2C_Bus_Config_t lsm6dsv16x_bus_cfg = I2C_BUS_CONFIG(LSM6DSV16X);
 static lsm6dsv16x_fifo_sflp_raw_t fifo_sflp;
 
 lsm6dsv16x_fifo_status_t fifo_status;
@@ -30,31 +31,13 @@ static void platform_delay(uint32_t ms);
 static void quat_to_euler(const float q[4], float *roll, float *pitch, float *yaw)
 {
     // q = [x, y, z, w] 格式
-    float x = q[0];
-    float y = q[1];
-    float z = q[2];
-    float w = q[3];
-
-    // Roll (x-axis rotation)
-    float sinr_cosp = 2.0f * (w * x + y * z);
-    float cosr_cosp = 1.0f - 2.0f * (x * x + y * y);
-    *roll = atan2f(sinr_cosp, cosr_cosp);
-
-    // Pitch (y-axis rotation)
-    float sinp = 2.0f * (w * y - z * x);
-    if (fabsf(sinp) >= 1.0f)
-        *pitch = copysignf(M_PI / 2.0f, sinp); // use 90 degrees if out of range
-    else
-        *pitch = asinf(sinp);
-
-    // Yaw (z-axis rotation)
-    float siny_cosp = 2.0f * (w * z + x * y);
-    float cosy_cosp = 1.0f - 2.0f * (y * y + z * z);
-    *yaw = atan2f(siny_cosp, cosy_cosp);
-
-    *roll *= RAD_TO_DEG;
-    *pitch *= RAD_TO_DEG;
-    *yaw *= RAD_TO_DEG;
+#if LSM6DSV16X_YAW_ONLY
+    FastMath_QuatToEuler(q[3], q[0], q[1], q[2], NULL, NULL, yaw);
+    (void)roll;
+    (void)pitch;
+#else
+    FastMath_QuatToEuler(q[3], q[0], q[1], q[2], roll, pitch, yaw);
+#endif
 }
 
 static float_t npy_half_to_float(uint16_t h)
@@ -81,14 +64,14 @@ static void sflp2q(float_t quat[4], uint8_t raw[6])
         sumsq += quat[i] * quat[i];
 
     if (sumsq > 1.0f) {
-        float_t n = sqrtf(sumsq);
-        quat[0] /= n;
-        quat[1] /= n;
-        quat[2] /= n;
+        float_t inv = FastMath_Div(1.0f, FastMath_Sqrt(sumsq));
+        quat[0] *= inv;
+        quat[1] *= inv;
+        quat[2] *= inv;
         sumsq = 1.0f;
     }
 
-    quat[3] = sqrtf(1.0f - sumsq);
+    quat[3] = FastMath_Sqrt(1.0f - sumsq);
 }
 
 void LSM6DSV16X_Init(void)
@@ -189,53 +172,6 @@ void Read_LSM6DSV16X(void)
     }
 }
 
-static int mspm0_i2c_disable(void)
-{
-    DL_I2C_reset(I2C_LSM6DSV16X_INST);
-    DL_GPIO_initDigitalOutput(GPIO_I2C_LSM6DSV16X_IOMUX_SCL);
-    DL_GPIO_initDigitalInputFeatures(GPIO_I2C_LSM6DSV16X_IOMUX_SDA,
-		 DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_NONE,
-		 DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_clearPins(GPIO_I2C_LSM6DSV16X_SCL_PORT, GPIO_I2C_LSM6DSV16X_SCL_PIN);
-    DL_GPIO_enableOutput(GPIO_I2C_LSM6DSV16X_SCL_PORT, GPIO_I2C_LSM6DSV16X_SCL_PIN);
-    return 0;
-}
-
-static int mspm0_i2c_enable(void)
-{
-    DL_I2C_reset(I2C_LSM6DSV16X_INST);
-    DL_GPIO_initPeripheralInputFunctionFeatures(GPIO_I2C_LSM6DSV16X_IOMUX_SDA,
-        GPIO_I2C_LSM6DSV16X_IOMUX_SDA_FUNC, DL_GPIO_INVERSION_DISABLE,
-        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
-        DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_initPeripheralInputFunctionFeatures(GPIO_I2C_LSM6DSV16X_IOMUX_SCL,
-        GPIO_I2C_LSM6DSV16X_IOMUX_SCL_FUNC, DL_GPIO_INVERSION_DISABLE,
-        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
-        DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_enableHiZ(GPIO_I2C_LSM6DSV16X_IOMUX_SDA);
-    DL_GPIO_enableHiZ(GPIO_I2C_LSM6DSV16X_IOMUX_SCL);
-    DL_I2C_enablePower(I2C_LSM6DSV16X_INST);
-    SYSCFG_DL_I2C_LSM6DSV16X_init();
-    return 0;
-}
-
-static void mspm0_i2c_sda_unlock(void)
-{
-    uint8_t cycleCnt = 0;
-    mspm0_i2c_disable();
-    do
-    {
-        DL_GPIO_clearPins(GPIO_I2C_LSM6DSV16X_SCL_PORT, GPIO_I2C_LSM6DSV16X_SCL_PIN);
-        mspm0_delay_ms(1);
-        DL_GPIO_setPins(GPIO_I2C_LSM6DSV16X_SCL_PORT, GPIO_I2C_LSM6DSV16X_SCL_PIN);
-        mspm0_delay_ms(1);
-
-        if(DL_GPIO_readPins(GPIO_I2C_LSM6DSV16X_SDA_PORT, GPIO_I2C_LSM6DSV16X_SDA_PIN))
-            break;
-    }while(++cycleCnt < 100);
-    mspm0_i2c_enable();
-}
-
 /*
  * @brief  Write generic device register (platform dependent)
  *
@@ -248,37 +184,10 @@ static void mspm0_i2c_sda_unlock(void)
  */
 static int32_t platform_write(void *handle, uint8_t reg, const uint8_t *bufp, uint16_t len)
 {
-    unsigned int cnt = len;
-    unsigned char const *ptr = bufp;
-    unsigned long start, cur;
-
     if (!len)
         return 0;
 
-    mspm0_get_clock_ms(&start);
-
-    DL_I2C_transmitControllerData(I2C_LSM6DSV16X_INST, reg);
-    DL_I2C_clearInterruptStatus(I2C_LSM6DSV16X_INST, DL_I2C_INTERRUPT_CONTROLLER_TX_DONE);
-
-    while (!(DL_I2C_getControllerStatus(I2C_LSM6DSV16X_INST) & DL_I2C_CONTROLLER_STATUS_IDLE));
-
-    DL_I2C_startControllerTransfer(I2C_LSM6DSV16X_INST, LSM6DSV16X_ADDR, DL_I2C_CONTROLLER_DIRECTION_TX, len+1);
-
-    do {
-        unsigned fillcnt;
-        fillcnt = DL_I2C_fillControllerTXFIFO(I2C_LSM6DSV16X_INST, ptr, cnt);
-        cnt -= fillcnt;
-        ptr += fillcnt;
-
-        mspm0_get_clock_ms(&cur);
-        if(cur >= (start + I2C_TIMEOUT_MS))
-        {
-            mspm0_i2c_sda_unlock();
-            return -1;
-        }
-    } while (!DL_I2C_getRawInterruptStatus(I2C_LSM6DSV16X_INST, DL_I2C_INTERRUPT_CONTROLLER_TX_DONE));
-
-    return 0;
+    return I2C_Bus_WriteReg(I2C_Bus_Open(&lsm6dsv16x_bus_cfg), LSM6DSV16X_ADDR, reg, bufp, len);
 }
 
 /*
@@ -293,61 +202,10 @@ static int32_t platform_write(void *handle, uint8_t reg, const uint8_t *bufp, ui
  */
 static int32_t platform_read(void *handle, uint8_t reg, uint8_t *bufp, uint16_t len)
 {
-    unsigned i = 0;
-    unsigned long start, cur;
-
     if (!len)
         return 0;
 
-    mspm0_get_clock_ms(&start);
-
-    DL_I2C_transmitControllerData(I2C_LSM6DSV16X_INST, reg);
-    I2C_LSM6DSV16X_INST->MASTER.MCTR = I2C_MCTR_RD_ON_TXEMPTY_ENABLE;
-    DL_I2C_clearInterruptStatus(I2C_LSM6DSV16X_INST, DL_I2C_INTERRUPT_CONTROLLER_RX_DONE);
-
-    while (!(DL_I2C_getControllerStatus(I2C_LSM6DSV16X_INST) & DL_I2C_CONTROLLER_STATUS_IDLE));
-
-    DL_I2C_startControllerTransfer(I2C_LSM6DSV16X_INST, LSM6DSV16X_ADDR, DL_I2C_CONTROLLER_DIRECTION_RX, len);
-
-    do {
-        if (!DL_I2C_isControllerRXFIFOEmpty(I2C_LSM6DSV16X_INST))
-        {
-            uint8_t c;
-            c = DL_I2C_receiveControllerData(I2C_LSM6DSV16X_INST);
-            if (i < len)
-            {
-                bufp[i] = c;
-                ++i;
-            }
-        }
-        
-        mspm0_get_clock_ms(&cur);
-        if(cur >= (start + I2C_TIMEOUT_MS))
-        {
-            mspm0_i2c_sda_unlock();
-            return -1;
-        }
-    } while(!DL_I2C_getRawInterruptStatus(I2C_LSM6DSV16X_INST, DL_I2C_INTERRUPT_CONTROLLER_RX_DONE));
-
-    if (!DL_I2C_isControllerRXFIFOEmpty(I2C_LSM6DSV16X_INST))
-    {
-        uint8_t c;
-        c = DL_I2C_receiveControllerData(I2C_LSM6DSV16X_INST);
-        if (i < len)
-        {
-            bufp[i] = c;
-            ++i;
-        }
-    }
-
-    I2C_LSM6DSV16X_INST->MASTER.MCTR = 0;
-    DL_I2C_flushControllerTXFIFO(I2C_LSM6DSV16X_INST);
-
-    if(i == len)
-        return 0;
-    else
-        return -1;
-    return 0;
+    return I2C_Bus_ReadReg(I2C_Bus_Open(&lsm6dsv16x_bus_cfg), LSM6DSV16X_ADDR, reg, bufp, len);
 }
 
 /*
@@ -20,6 +20,11 @@
 #ifndef _LSM6DSV16X_H_
 #define _LSM6DSV16X_H_
 
+// 1：只计算yaw（pitch/roll保持不变）；0：三个角都计算
+#ifndef LSM6DSV16X_YAW_ONLY
+#define LSM6DSV16X_YAW_ONLY 0
+#endif
+
 extern short gyro[3], accel[3];
 extern float pitch, roll, yaw;
 
@@ -6,32 +6,205 @@
  */
 
 #include "linetracker.h"
-#include <stdio.h>
+#include "seqlock.h"
+#include "clock.h"
+// #include <stdio.h>     // 只有下面已注释的调试功能用到printf，打开调试时一并打开
 #include <string.h>
 
-// 全局变量定义
+// 全局变量定义（已发布的传感器快照，多字段读取请使用LineTracker_GetSnapshot）
 LineTracker_t g_lineTracker;
 
-// 传感器权重数组（用于位置计算）
-static const int16_t sensorWeights[LINE_SENSOR_COUNT] = {
-    SENSOR_WEIGHT_0, SENSOR_WEIGHT_1, SENSOR_WEIGHT_2, SENSOR_WEIGHT_3,
-    SENSOR_WEIGHT_4, SENSOR_WEIGHT_5, SENSOR_WEIGHT_6
+// g_lineTracker的发布序号
+static seqlock_t lineTrackerLock;
+
+// 线位置滤波器状态（只在ReadSensors中读写）
+static int32_t filterPos;           // 估计位置（Q8）
+static int32_t filterVel;           // 估计变化率（Q16/ms）
+static uint32_t filterLastTick;     // 上次更新时间
+static uint32_t filterLostTick;     // 开始丢线的时间
+static bool filterValid;            // 是否已有有效估计
+static bool filterLost;             // 是否处于丢线状态
+
+// 速度修正按采样间隔归一化：1/dt查表（Q8），dt超过上限时按上限计（只在丢线恢复等少见情况出现）
+#define LT_DT_MAX       8
+#define LT_RECIP_Q8(n)  ((256 + (n) / 2) / (n))
+static const uint8_t filterRecipQ8[LT_DT_MAX + 1] = {
+    0, 0, LT_RECIP_Q8(2), LT_RECIP_Q8(3), LT_RECIP_Q8(4),
+    LT_RECIP_Q8(5), LT_RECIP_Q8(6), LT_RECIP_Q8(7), LT_RECIP_Q8(8)
 };
 
-// 传感器GPIO端口和引脚配置
+/* ======================== 编译期生成的位图查找表 ======================== */
+
+// 位图第i位（传感器i）是否激活
+#define LT_BIT(b, i)    (((b) >> (i)) & 1)
+
+// 激活的传感器数量
+#define LT_COUNT(b)     (LT_BIT(b,0) + LT_BIT(b,1) + LT_BIT(b,2) + LT_BIT(b,3) + \
+                         LT_BIT(b,4) + LT_BIT(b,5) + LT_BIT(b,6))
+
+// 激活传感器的权重和
+#define LT_SUM(b)       (LT_BIT(b,0) * SENSOR_WEIGHT_0 + LT_BIT(b,1) * SENSOR_WEIGHT_1 + \
+                         LT_BIT(b,2) * SENSOR_WEIGHT_2 + LT_BIT(b,3) * SENSOR_WEIGHT_3 + \
+                         LT_BIT(b,4) * SENSOR_WEIGHT_4 + LT_BIT(b,5) * SENSOR_WEIGHT_5 + \
+                         LT_BIT(b,6) * SENSOR_WEIGHT_6)
+
+// 加权平均位置（与原运行时算法相同，整数除法向零截断）
+#define LT_POS(b)       (LT_COUNT(b) ? LT_SUM(b) / LT_COUNT(b) : 0)
+
+// 重心位置（Q8，与原运行时 权重和 × 256 / 数量 相同，向零截断）
+#define LT_CENTROID(b)  (LT_COUNT(b) ? LT_SUM(b) * (1 << LINE_POS_Q) / LT_COUNT(b) : 0)
+
+// 线状态（与原switch判断顺序一致）
+#define LT_IS_ON(b)     ((b) == 0x08 || (b) == 0x18 || (b) == 0x0C || (b) == 0x1C)
+#define LT_IS_LEFT(b)   ((b) == 0x01 || (b) == 0x03 || (b) == 0x07 || (b) == 0x30 || (b) == 0x38)
+#define LT_IS_RIGHT(b)  ((b) == 0x40 || (b) == 0x60 || (b) == 0x70 || (b) == 0x06 || (b) == 0x0E)
+#define LT_IS_SLEFT(b)  ((b) == 0x02 || (b) == 0x04)
+#define LT_IS_SRIGHT(b) ((b) == 0x20 || (b) == 0x10)
+#define LT_STATE(b) \
+    (LT_COUNT(b) == 0                 ? LINE_STATE_NO_LINE     : \
+     LT_COUNT(b) == LINE_SENSOR_COUNT ? LINE_STATE_ALL_LINE    : \
+     LT_IS_ON(b)                      ? LINE_STATE_ON_LINE     : \
+     LT_IS_LEFT(b)                    ? LINE_STATE_LEFT_TURN   : \
+     LT_IS_RIGHT(b)                   ? LINE_STATE_RIGHT_TURN  : \
+     LT_IS_SLEFT(b)                   ? LINE_STATE_SHARP_LEFT  : \
+     LT_IS_SRIGHT(b)                  ? LINE_STATE_SHARP_RIGHT : \
+     LT_POS(b) < -15                  ? LINE_STATE_LEFT_TURN   : \
+     LT_POS(b) > 15                   ? LINE_STATE_RIGHT_TURN  : \
+                                        LINE_STATE_ON_LINE)
+
+#define LT_ENTRY(b)     { (int8_t)LT_POS(b), (int8_t)LT_SUM(b), (uint8_t)LT_COUNT(b), (uint8_t)LT_STATE(b), \
+                          (int16_t)LT_CENTROID(b) }
+#define LT_ROW8(b)      LT_ENTRY(b),     LT_ENTRY(b + 1), LT_ENTRY(b + 2), LT_ENTRY(b + 3), \
+                        LT_ENTRY(b + 4), LT_ENTRY(b + 5), LT_ENTRY(b + 6), LT_ENTRY(b + 7)
+
+// 位图 -> {位置, 权重和, 激活数量, 线状态, 重心(Q8)}，共128项
 static const struct {
-    uint32_t port;
-    uint32_t pin;
-} sensorPins[LINE_SENSOR_COUNT] = {
-    {(uint32_t)GPIO_TRM_PIN_OUT1_PORT, GPIO_TRM_PIN_OUT1_PIN},  // 传感器0 - 最左边
-    {(uint32_t)GPIO_TRM_PIN_OUT2_PORT, GPIO_TRM_PIN_OUT2_PIN},  // 传感器1
-    {(uint32_t)GPIO_TRM_PIN_OUT3_PORT, GPIO_TRM_PIN_OUT3_PIN},  // 传感器2
-    {(uint32_t)GPIO_TRM_PIN_OUT4_PORT, GPIO_TRM_PIN_OUT4_PIN},  // 传感器3 - 中间
-    {(uint32_t)GPIO_TRM_PIN_OUT5_PORT, GPIO_TRM_PIN_OUT5_PIN},  // 传感器4
-    {(uint32_t)GPIO_TRM_PIN_OUT6_PORT, GPIO_TRM_PIN_OUT6_PIN},  // 传感器5
-    {(uint32_t)GPIO_TRM_PIN_OUT7_PORT, GPIO_TRM_PIN_OUT7_PIN}   // 传感器6 - 最右边
+    int8_t position;
+    int8_t sum;
+    uint8_t count;
+    uint8_t state;
+    int16_t centroid;
+} lineLUT[1 << LINE_SENSOR_COUNT] = {
+    LT_ROW8(0),  LT_ROW8(8),  LT_ROW8(16), LT_ROW8(24), LT_ROW8(32),  LT_ROW8(40),  LT_ROW8(48),  LT_ROW8(56),
+    LT_ROW8(64), LT_ROW8(72), LT_ROW8(80), LT_ROW8(88), LT_ROW8(96),  LT_ROW8(104), LT_ROW8(112), LT_ROW8(120)
 };
 
+/* ======================== 端口采样 ======================== */
+
+// 从GPIOA/GPIOB两次读取的结果中取出传感器n的电平，放到位图第bit位（常量掩码，编译为移位+与）
+#define LT_PORT_VAL(n, a, b)  ((GPIO_TRM_PIN_OUT##n##_PORT == GPIOA) ? (a) : (b))
+#define LT_GATHER(n, bit, a, b) \
+    (((LT_PORT_VAL(n, a, b) & GPIO_TRM_PIN_OUT##n##_PIN) ? 1u : 0u) << (bit))
+
+// 各端口上的传感器引脚掩码
+#define LT_PINS_ON(port) \
+    (((GPIO_TRM_PIN_OUT1_PORT == (port)) ? GPIO_TRM_PIN_OUT1_PIN : 0) | \
+     ((GPIO_TRM_PIN_OUT2_PORT == (port)) ? GPIO_TRM_PIN_OUT2_PIN : 0) | \
+     ((GPIO_TRM_PIN_OUT3_PORT == (port)) ? GPIO_TRM_PIN_OUT3_PIN : 0) | \
+     ((GPIO_TRM_PIN_OUT4_PORT == (port)) ? GPIO_TRM_PIN_OUT4_PIN : 0) | \
+     ((GPIO_TRM_PIN_OUT5_PORT == (port)) ? GPIO_TRM_PIN_OUT5_PIN : 0) | \
+     ((GPIO_TRM_PIN_OUT6_PORT == (port)) ? GPIO_TRM_PIN_OUT6_PIN : 0) | \
+     ((GPIO_TRM_PIN_OUT7_PORT == (port)) ? GPIO_TRM_PIN_OUT7_PIN : 0))
+
+/**
+ * @brief 读取两个端口并拼成7位传感器位图（bit0=最左边传感器）
+ */
+static uint8_t LineTracker_ReadBits(void)
+{
+    uint32_t a = DL_GPIO_readPins(GPIOA, LT_PINS_ON(GPIOA));
+    uint32_t b = DL_GPIO_readPins(GPIOB, LT_PINS_ON(GPIOB));
+
+    uint8_t bits = (uint8_t)(LT_GATHER(1, 0, a, b) | LT_GATHER(2, 1, a, b) | LT_GATHER(3, 2, a, b) |
+                             LT_GATHER(4, 3, a, b) | LT_GATHER(5, 4, a, b) | LT_GATHER(6, 5, a, b) |
+                             LT_GATHER(7, 6, a, b));
+
+    #if SENSOR_LOGIC_INVERTED
+        // 反向逻辑：高电平=检测到黑线，直接使用
+        return bits;
+    #else
+        // 正常逻辑：低电平=检测到黑线，取反
+        return bits ^ ((1 << LINE_SENSOR_COUNT) - 1);
+    #endif
+}
+
+/**
+ * @brief 线位置alpha-beta滤波
+ * @param bits 传感器位图
+ * @return 滤波后的位置（Q8）
+ * @note 重心取自查找表，速度修正用1/dt查表，采样路径中没有运行时除法。
+ *       位图重心只有5的整数倍几档，直接进PID会形成阶梯，D项会放大跳变。
+ *       这里用预测+修正的方式在历史位置和变化率上平滑，得到连续的位置；
+ *       丢线后按最后的变化率短时外推，超时后保持不动；重新看到线时直接对齐测量值。
+ */
+static int32_t LineTracker_FilterPosition(uint8_t bits)
+{
+    uint32_t now = tick_ms;
+    uint32_t dt = now - filterLastTick;
+    uint8_t count = lineLUT[bits].count;
+    int32_t meas = lineLUT[bits].centroid;
+    int32_t residual, dv;
+
+    // 同一毫秒内的重复调用（TIMA1与TIMG8）不推进滤波器
+    if (filterValid && dt == 0) {
+        return filterPos;
+    }
+    filterLastTick = now;
+
+    // 第一次测量或丢线超时后重新看到线：直接对齐
+    if (!filterValid) {
+        if (count == 0) {
+            return 0;
+        }
+        filterPos = meas;
+        filterVel = 0;
+        filterValid = true;
+        filterLost = false;
+        return filterPos;
+    }
+
+    // 预测
+    filterPos += (filterVel * (int32_t)dt) >> 8;
+
+    if (count == 0) {
+        // 丢线：外推一段时间后停止
+        if (!filterLost) {
+            filterLost = true;
+            filterLostTick = now;
+        }
+        if (now - filterLostTick >= LINE_EXTRAPOLATE_MS) {
+            filterVel = 0;
+        }
+    } else if (count <= LINE_FILTER_MAX_COUNT) {
+        if (filterLost && now - filterLostTick >= LINE_EXTRAPOLATE_MS) {
+            // 长时间丢线后重新找到线，历史已无参考价值
+            filterPos = meas;
+            filterVel = 0;
+        } else {
+            // 修正
+            residual = meas - filterPos;
+            filterPos += residual >> LINE_FILTER_ALPHA_SHIFT;
+            // 除以dt：1ms（TIMG8正常周期）直接累加，否则乘查表的1/dt
+            dv = residual * (1 << 8) >> LINE_FILTER_BETA_SHIFT;
+            if (dt > 1) {
+                dv = (dv * filterRecipQ8[dt < LT_DT_MAX ? dt : LT_DT_MAX]) >> 8;
+            }
+            filterVel += dv;
+        }
+        filterLost = false;
+    }
+
+    // 限幅
+    if (filterPos > LINE_EXTRAPOLATE_LIMIT * (1 << LINE_POS_Q)) {
+        filterPos = LINE_EXTRAPOLATE_LIMIT * (1 << LINE_POS_Q);
+        filterVel = 0;
+    } else if (filterPos < -LINE_EXTRAPOLATE_LIMIT * (1 << LINE_POS_Q)) {
+        filterPos = -LINE_EXTRAPOLATE_LIMIT * (1 << LINE_POS_Q);
+        filterVel = 0;
+    }
+
+    return filterPos;
+}
+
 /**
  * @brief 初始化循迹传感器
  */
@@ -39,62 +212,70 @@ void LineTracker_Init(void)
 {
     // 清空数据结构
     memset(&g_lineTracker, 0, sizeof(LineTracker_t));
+    lineTrackerLock.seq = 0;
+    filterValid = false;
+    filterLost = false;
     
     // GPIO已经在ti_msp_dl_config.c中配置，这里只需要确保引脚已经初始化
     // 传感器引脚配置为输入模式，在SysConfig中已经完成
     
-    printf("LineTracker: 初始化完成，7路传感器已配置\n");
+    // printf("LineTracker: 初始化完成，7路传感器已配置\n");   // 调试输出，避免链接newlib stdio
 }
 
 /**
  * @brief 读取所有传感器的值（用于中断中快速读取）
+ * @note 与LineTracker_ReadSensors相同：采样和计算都在局部变量中完成，最后整体发布，
+ *       读者不会看到sensorBits与linePosition不匹配的中间状态
  */
 void LineTracker_ReadSensors_Interrupt(void)
 {
+    LineTracker_ReadSensors();
+}
+
+/**
+ * @brief 读取所有传感器的值
+ * @note 只应在中断上下文调用（TIMG8转弯检测、TIMA1电机控制，二者优先级相同不会互相抢占），
+ *       主循环请使用LineTracker_GetSnapshot读取
+ */
+void LineTracker_ReadSensors(void)
+{
+    LineTracker_t lt;
     uint8_t i;
-    
-    // 清空之前的状态
-    g_lineTracker.sensorBits = 0;
-    g_lineTracker.activeSensorCount = 0;
-    
-    // 读取每个传感器的值
+
+    // 两次端口读取得到位图，其余字段查表
+    uint8_t bits = LineTracker_ReadBits();
+    lt.sensorBits = bits;
+    lt.activeSensorCount = lineLUT[bits].count;
+    lt.lineState = (LineState_t)lineLUT[bits].state;
+    lt.lineDetected = (bits != 0);
+
+    // 无线时保持上次发布的位置
+    lt.linePosition = bits ? lineLUT[bits].position : g_lineTracker.linePosition;
+
     for (i = 0; i < LINE_SENSOR_COUNT; i++) {
-        // 读取GPIO引脚状态
-        uint32_t pinState = DL_GPIO_readPins((GPIO_Regs *)sensorPins[i].port, sensorPins[i].pin);
-        
-        // 根据配置决定传感器逻辑
-        #if SENSOR_LOGIC_INVERTED
-            // 反向逻辑：低电平=白色背景，高电平=检测到黑线
-            g_lineTracker.sensorValue[i] = (pinState != 0) ? 1 : 0;
-        #else
-            // 正常逻辑：高电平=白色背景，低电平=检测到黑线
-            g_lineTracker.sensorValue[i] = (pinState != 0) ? 0 : 1;
-        #endif
-        
-        // 更新位图
-        if (g_lineTracker.sensorValue[i]) {
-            g_lineTracker.sensorBits |= (1 << i);
-            g_lineTracker.activeSensorCount++;
-        }
+        lt.sensorValue[i] = (bits >> i) & 1;
     }
+
+    lt.linePositionQ8 = LineTracker_FilterPosition(bits);
+
+    // 发布
+    seqlock_write_begin(&lineTrackerLock);
+    g_lineTracker = lt;
+    seqlock_write_end(&lineTrackerLock);
 }
 
 /**
- * @brief 读取所有传感器的值
+ * @brief 获取一份完整一致的传感器数据快照
+ * @param out 输出快照
+ * @note 无锁读取：若读取过程中被中断更新则自动重读，不需要关中断
  */
-void LineTracker_ReadSensors(void)
+void LineTracker_GetSnapshot(LineTracker_t *out)
 {
-    // 使用中断版本的读取函数
-    LineTracker_ReadSensors_Interrupt();
-    
-    // 计算线位置
-    g_lineTracker.linePosition = LineTracker_GetLinePosition();
-    
-    // 确定线状态
-    g_lineTracker.lineState = LineTracker_GetLineState();
-    
-    // 更新线检测状态
-    g_lineTracker.lineDetected = (g_lineTracker.activeSensorCount > 0);
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&lineTrackerLock);
+        *out = g_lineTracker;
+    } while (seqlock_read_retry(&lineTrackerLock, seq));
 }
 
 /**
@@ -103,28 +284,16 @@ void LineTracker_ReadSensors(void)
  */
 int16_t LineTracker_GetLinePosition(void)
 {
-    int32_t weightedSum = 0;
-    int32_t totalWeight = 0;
-    uint8_t i;
-    
-    // 如果没有传感器激活，返回上次的位置
-    if (g_lineTracker.activeSensorCount == 0) {
-        return g_lineTracker.linePosition;
-    }
-    
-    // 计算加权平均位置
-    for (i = 0; i < LINE_SENSOR_COUNT; i++) {
-        if (g_lineTracker.sensorValue[i]) {
-            weightedSum += sensorWeights[i];
-            totalWeight += 1;
-        }
-    }
-    
-    if (totalWeight > 0) {
-        return (int16_t)(weightedSum / totalWeight);
-    }
-    
-    return 0;
+    return g_lineTracker.linePosition;
+}
+
+/**
+ * @brief 获取滤波后的高分辨率线位置
+ * @return 线的位置值（约-40到40，0表示在中间，带小数）
+ */
+float LineTracker_GetLinePositionFiltered(void)
+{
+    return (float)g_lineTracker.linePositionQ8 / (1 << LINE_POS_Q);
 }
 
 /**
@@ -133,63 +302,7 @@ int16_t LineTracker_GetLinePosition(void)
  */
 LineState_t LineTracker_GetLineState(void)
 {
-    uint8_t bits = g_lineTracker.sensorBits;
-    uint8_t count = g_lineTracker.activeSensorCount;
-    
-    // 没有检测到线
-    if (count == 0) {
-        return LINE_STATE_NO_LINE;
-    }
-    
-    // 所有传感器都检测到线（可能是起始线或十字路口）
-    if (count == LINE_SENSOR_COUNT) {
-        return LINE_STATE_ALL_LINE;
-    }
-    
-    // 根据传感器模式判断状态
-    switch (bits) {
-        // 中间传感器激活 - 在线上
-        case 0b0001000:  // 只有中间传感器
-        case 0b0011000:  // 中间和左中
-        case 0b0001100:  // 中间和右中
-        case 0b0011100:  // 中间三个
-            return LINE_STATE_ON_LINE;
-            
-        // 左转情况
-        case 0b0000001:  // 最左边
-        case 0b0000011:  // 左边两个
-        case 0b0000111:  // 左边三个
-        case 0b0110000:  // 左中两个
-        case 0b0111000:  // 左中三个
-            return LINE_STATE_LEFT_TURN;
-            
-        // 右转情况
-        case 0b1000000:  // 最右边
-        case 0b1100000:  // 右边两个
-        case 0b1110000:  // 右边三个
-        case 0b0000110:  // 右中两个
-        case 0b0001110:  // 右中三个
-            return LINE_STATE_RIGHT_TURN;
-            
-        // 急转弯情况 - 只有边缘传感器激活
-        case 0b0000010:  // 只有左二
-        case 0b0000100:  // 只有左三
-            return LINE_STATE_SHARP_LEFT;
-            
-        case 0b0100000:  // 只有右二
-        case 0b0010000:  // 只有右三
-            return LINE_STATE_SHARP_RIGHT;
-            
-        default:
-            // 根据位置判断
-            if (g_lineTracker.linePosition < -15) {
-                return LINE_STATE_LEFT_TURN;
-            } else if (g_lineTracker.linePosition > 15) {
-                return LINE_STATE_RIGHT_TURN;
-            } else {
-                return LINE_STATE_ON_LINE;
-            }
-    }
+    return g_lineTracker.lineState;
 }
 
 /**
@@ -239,7 +352,7 @@ void LineTracker_Calibrate(void)
 {
     // 这里可以实现传感器校准功能
     // 例如：记录传感器在白色和黑色表面的阈值
-    printf("LineTracker: 校准功能预留，当前使用默认阈值\n");
+    // printf("LineTracker: 校准功能预留，当前使用默认阈值\n");
 }
 
 /* ======================== 调试功能（已注释） ======================== */
@@ -284,22 +397,13 @@ void LineTracker_PrintStatus(void)
 /*
 void LineTracker_DebugGPIO(void)
 {
-    uint8_t i;
-    uint32_t rawValue;
+    uint32_t rawA = DL_GPIO_readPins(GPIOA, LT_PINS_ON(GPIOA));
+    uint32_t rawB = DL_GPIO_readPins(GPIOB, LT_PINS_ON(GPIOB));
     
     printf("=== GPIO调试信息 ===\n");
-    
-    for (i = 0; i < LINE_SENSOR_COUNT; i++) {
-        // 读取原始GPIO值
-        rawValue = DL_GPIO_readPins((GPIO_Regs *)sensorPins[i].port, sensorPins[i].pin);
-        
-        printf("传感器 %d: 端口=0x%08X, 引脚=0x%08X, 原始值=%lu, 处理后=%d\n", 
-               i, 
-               (uint32_t)sensorPins[i].port, 
-               sensorPins[i].pin, 
-               rawValue, 
-               rawValue ? 0 : 1);
-    }
+    printf("GPIOA掩码=0x%08lX 原始值=0x%08lX\n", (uint32_t)LT_PINS_ON(GPIOA), rawA);
+    printf("GPIOB掩码=0x%08lX 原始值=0x%08lX\n", (uint32_t)LT_PINS_ON(GPIOB), rawB);
+    printf("传感器位图(处理后)=0x%02X\n", LineTracker_ReadBits());
     
     printf("==================\n");
 }
@@ -31,6 +31,14 @@ extern "C" {
 #define SENSOR_WEIGHT_5     20
 #define SENSOR_WEIGHT_6     30      // 最右边传感器
 
+// 线位置滤波参数（alpha-beta滤波，融合当前位图、历史位置和位置变化率）
+#define LINE_POS_Q              8       // 滤波位置的定点小数位数（Q8，即位置×256）
+#define LINE_FILTER_ALPHA_SHIFT 5       // 位置修正增益 alpha = 1/32（1ms采样，时间常数约30ms）
+#define LINE_FILTER_BETA_SHIFT  11      // 速度修正增益 beta = 1/2048（约alpha²/2，接近临界阻尼）
+#define LINE_FILTER_MAX_COUNT   4       // 激活传感器超过此数量（路口、起始线）时重心不可信，只做预测
+#define LINE_EXTRAPOLATE_MS     60      // 丢线后按变化率外推的最长时间（ms），之后保持不动
+#define LINE_EXTRAPOLATE_LIMIT  40      // 外推位置限幅（超出最边缘传感器一点）
+
 // 循迹状态枚举
 typedef enum {
     LINE_STATE_ON_LINE = 0,         // 在线上
@@ -48,6 +56,7 @@ typedef struct {
     uint8_t sensorValue[LINE_SENSOR_COUNT];  // 原始传感器值（0或1）
     uint8_t sensorBits;                      // 传感器位图表示
     int16_t linePosition;                    // 线的位置（-30到30）
+    int32_t linePositionQ8;                  // 滤波后的高分辨率线位置（Q8，丢线时短时外推）
     LineState_t lineState;                   // 当前线状态
     uint8_t activeSensorCount;               // 激活的传感器数量
     bool lineDetected;                       // 是否检测到线
@@ -69,16 +78,28 @@ void LineTracker_Init(void);
 void LineTracker_ReadSensors_Interrupt(void);
 
 /**
- * @brief 读取所有传感器的值
+ * @brief 读取所有传感器的值并整体发布到g_lineTracker（只在中断上下文调用）
  */
 void LineTracker_ReadSensors(void);
 
+/**
+ * @brief 获取一份完整一致的传感器数据快照（主循环中读取多个字段时使用）
+ * @param out 输出快照
+ */
+void LineTracker_GetSnapshot(LineTracker_t *out);
+
 /**
  * @brief 计算线的位置
  * @return 线的位置值（-30到30，0表示在中间）
  */
 int16_t LineTracker_GetLinePosition(void);
 
+/**
+ * @brief 获取滤波后的高分辨率线位置
+ * @return 线的位置值（约-40到40，0表示在中间，带小数）
+ */
+float LineTracker_GetLinePositionFiltered(void);
+
 /**
  * @brief 获取当前线状态
  * @return 线状态枚举值
@@ -0,0 +1,151 @@
+#include "track_map.h"
+#include "Encoder.h"
+#include "motor_control.h"
+#include "fast_math.h"
+
+// 全局变量定义
+Track_Map_t g_trackMap;
+
+/**
+ * @brief 当前里程（两轮编码器平均计数）
+ */
+static int32_t TrackMap_Distance(void)
+{
+    return (Encoder_GetCount(0) + Encoder_GetCount(1)) / 2;
+}
+
+/**
+ * @brief 初始化（清空地图，恢复恒速行驶）
+ */
+void TrackMap_Init(void)
+{
+    g_trackMap.count = 0;
+    g_trackMap.index = 0;
+    g_trackMap.seg_start = TrackMap_Distance();
+    g_trackMap.state = TRACK_MAP_EMPTY;
+}
+
+/**
+ * @brief 清空地图，下一圈作为学习圈
+ */
+void TrackMap_StartLearning(void)
+{
+    TrackMap_Init();
+    g_trackMap.state = TRACK_MAP_LEARNING;
+}
+
+/**
+ * @brief 一圈开始
+ */
+void TrackMap_BeginLap(void)
+{
+    g_trackMap.index = 0;
+    g_trackMap.seg_start = TrackMap_Distance();
+}
+
+/**
+ * @brief 确认路口，结束当前直线段
+ * @param type 路口类型
+ * @note 学习圈追加一段（第一段标记为不完整）；之后各圈补测不完整段的长度。
+ *       路口数超过地图段数说明和学习圈不是同一条路线，地图作废回到恒速
+ */
+void TrackMap_MarkCorner(Junction_Type_t type)
+{
+    int32_t length = TrackMap_Distance() - g_trackMap.seg_start;
+    Track_Segment_t *seg;
+
+    if (length < 0) {
+        length = -length;
+    }
+
+    if (g_trackMap.state == TRACK_MAP_LEARNING) {
+        if (g_trackMap.count < TRACK_MAP_MAX_SEGMENTS) {
+            seg = &g_trackMap.seg[g_trackMap.count++];
+            seg->length = length;
+            seg->corner = type;
+            seg->partial = (g_trackMap.index == 0);
+        }
+    } else if (g_trackMap.state == TRACK_MAP_READY) {
+        if (g_trackMap.index >= g_trackMap.count || g_trackMap.seg[g_trackMap.index].corner != type) {
+            TrackMap_Init();
+            return;
+        }
+        seg = &g_trackMap.seg[g_trackMap.index];
+        if (seg->partial) {
+            seg->length = length;
+            seg->partial = false;
+        }
+    }
+    g_trackMap.index++;
+}
+
+/**
+ * @brief 转弯完成，从当前里程开始下一段直线
+ */
+void TrackMap_StartSegment(void)
+{
+    g_trackMap.seg_start = TrackMap_Distance();
+}
+
+/**
+ * @brief 一圈结束，学习圈记录到路口则地图可用
+ */
+void TrackMap_EndLap(void)
+{
+    if (g_trackMap.state == TRACK_MAP_LEARNING && g_trackMap.count > 0) {
+        g_trackMap.state = TRACK_MAP_READY;
+    }
+}
+
+/**
+ * @brief 当前段已行驶的里程
+ * @return 距段起点的距离（mm）
+ */
+float TrackMap_GetSegmentDistance(void)
+{
+    int32_t d = TrackMap_Distance() - g_trackMap.seg_start;
+    return (float)(d >= 0 ? d : -d) * MotorControl_GetMmPerPulse();
+}
+
+/**
+ * @brief 按地图计算当前应使用的速度
+ * @param v_max 直线最高速度
+ * @param v_corner 过弯速度（学习圈也用这个速度）
+ * @return 目标速度
+ * @note 取三者最小值：v_max、出弯加速 √(v_corner² + 2·ACCEL·已行驶)、
+ *       入弯减速 √(v_corner² + 2·BRAKE·(剩余 - 余量))。两条曲线在平方域比较，只开一次方。
+ *       不完整的段长度未知，按过弯速度行驶
+ */
+float TrackMap_GetSpeed(float v_max, float v_corner)
+{
+    const Track_Segment_t *seg;
+    float travelled, remaining, v2, v2_brake;
+
+    if (g_trackMap.state == TRACK_MAP_EMPTY) {
+        return v_max;
+    }
+    if (g_trackMap.state == TRACK_MAP_LEARNING || g_trackMap.index >= g_trackMap.count) {
+        return v_corner;
+    }
+
+    seg = &g_trackMap.seg[g_trackMap.index];
+    if (seg->partial) {
+        return v_corner;
+    }
+
+    travelled = TrackMap_GetSegmentDistance();
+    remaining = (float)seg->length * MotorControl_GetMmPerPulse() - travelled - TRACK_MAP_BRAKE_MARGIN_MM;
+    if (remaining < 0.0f) {
+        remaining = 0.0f;
+    }
+
+    v2 = v_corner * v_corner + 2.0f * TRACK_MAP_ACCEL_MMPS2 * travelled;
+    v2_brake = v_corner * v_corner + 2.0f * TRACK_MAP_BRAKE_MMPS2 * remaining;
+    if (v2 > v2_brake) {
+        v2 = v2_brake;
+    }
+    if (v2 >= v_max * v_max) {
+        return v_max;
+    }
+    return FastMath_Sqrt(v2);
+}
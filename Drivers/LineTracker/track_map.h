@@ -0,0 +1,67 @@
+#ifndef TRACK_MAP_H
+#define TRACK_MAP_H
+
+/*
+ * 赛道地图学习与预测速度规划
+ *
+ * 多圈跑同一条赛道时，第一圈（学习圈）以保守的过弯速度行驶，记录每段直线的长度（编码器里程）
+ * 和段末的路口类型；之后各圈按地图规划速度：出弯后加速，离下一个已知路口还有足够距离时开始
+ * 减速，在路口处降到过弯速度。加减速按匀加速运动学 v = √(v_c² + 2·a·d) 规划。
+ *
+ * 用法（每圈）：
+ *   TrackMap_BeginLap()                  圈开始
+ *   MotorControl_SetBaseSpeed(TrackMap_GetSpeed(v_max, v_corner))   循迹时周期调用
+ *   TrackMap_MarkCorner(type)            确认路口时
+ *   TrackMap_StartSegment()              转弯完成、开始下一段直线时
+ *   TrackMap_EndLap()                    圈结束
+ * 速度单位与base_speed相同（mm/s）。
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "turn_detection.h"
+
+// 地图参数
+#define TRACK_MAP_MAX_SEGMENTS      16      // 一圈最多记录的直线段数
+// 加减速度：4.2→6.3mm/s约300mm加速完、约190mm减速完（远低于速度规划器的MOTOR_PROFILE_ACCEL）
+#define TRACK_MAP_ACCEL_MMPS2       0.037f  // 出弯加速度（mm/s²）
+#define TRACK_MAP_BRAKE_MMPS2       0.059f  // 入弯减速度（mm/s²）
+#define TRACK_MAP_BRAKE_MARGIN_MM   40.0f   // 提前降到过弯速度的距离（路口在确认点之前，另留余量）
+
+// 地图状态
+typedef enum {
+    TRACK_MAP_EMPTY = 0,        // 没有地图，按最高速度恒速行驶（原来的行为）
+    TRACK_MAP_LEARNING,         // 学习圈，按过弯速度行驶并记录
+    TRACK_MAP_READY             // 地图可用，按规划速度行驶
+} Track_Map_State_t;
+
+// 直线段
+typedef struct {
+    int32_t length;             // 从段起点到路口确认点的里程（脉冲）
+    Junction_Type_t corner;     // 段末路口类型
+    bool partial;               // 学习圈第一段从出发点开始，长度不完整，下一圈重新测量
+} Track_Segment_t;
+
+// 地图
+typedef struct {
+    Track_Segment_t seg[TRACK_MAP_MAX_SEGMENTS];
+    uint8_t count;              // 已记录的段数
+    uint8_t index;              // 当前所在段
+    int32_t seg_start;          // 当前段起点里程（脉冲）
+    Track_Map_State_t state;    // 地图状态
+} Track_Map_t;
+
+// 全局变量声明
+extern Track_Map_t g_trackMap;
+
+// 函数声明
+void TrackMap_Init(void);
+void TrackMap_StartLearning(void);
+void TrackMap_BeginLap(void);
+void TrackMap_MarkCorner(Junction_Type_t type);
+void TrackMap_StartSegment(void);
+void TrackMap_EndLap(void);
+float TrackMap_GetSpeed(float v_max, float v_corner);
+float TrackMap_GetSegmentDistance(void);
+
+#endif /* TRACK_MAP_H */
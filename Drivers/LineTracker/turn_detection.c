@@ -1,11 +1,141 @@
 #include "turn_detection.h"
 #include "linetracker.h"
+#include "Encoder.h"
+#include "motor_control.h"
 #include "clock.h"
 #include "ti_msp_dl_config.h"
 
 // 全局变量定义
 Turn_Detection_t g_turnDetection;
 
+// 分类表：下标 = saw_left | saw_right << 1 | saw_straight << 2
+static const Junction_Type_t junctionTable[8] = {
+    JUNCTION_END,               // 000: 无分支，直行无线（不会出现，分支窗口至少有一侧）
+    JUNCTION_LEFT,              // 001: 左分支，直行无线
+    JUNCTION_RIGHT,             // 010: 右分支，直行无线
+    JUNCTION_T,                 // 011: 左右分支，直行无线
+    JUNCTION_NONE,              // 100: 无分支，直行有线
+    JUNCTION_LEFT_BRANCH,       // 101: 左分支，直行有线
+    JUNCTION_RIGHT_BRANCH,      // 110: 右分支，直行有线
+    JUNCTION_CROSS              // 111: 左右分支，直行有线
+};
+
+// 事件队列（TIMG8中断写，主循环读，单生产者单消费者无需关中断）
+static Junction_Event_t eventQueue[JUNCTION_EVENT_QUEUE_SIZE];
+static volatile uint8_t eventHead;      // 写位置（中断修改）
+static volatile uint8_t eventTail;      // 读位置（主循环修改）
+
+/**
+ * @brief 统计位图中置位的数量
+ */
+static uint8_t TurnDetection_CountBits(uint8_t bits)
+{
+    uint8_t count = 0;
+    while (bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 当前里程（两轮编码器平均计数）
+ */
+static int32_t TurnDetection_Distance(void)
+{
+    return (Encoder_GetCount(0) + Encoder_GetCount(1)) / 2;
+}
+
+/**
+ * @brief 自某个里程起行驶过的距离（取绝对值，倒车同样计入）
+ * @return 距离（mm，按标定后的每脉冲里程换算）
+ */
+static float TurnDetection_Travelled(int32_t start_distance)
+{
+    int32_t d = TurnDetection_Distance() - start_distance;
+    return (float)(d >= 0 ? d : -d) * MotorControl_GetMmPerPulse();
+}
+
+/**
+ * @brief 进入抑制状态，从当前里程开始计算抑制距离
+ * @note 先写起点再切状态：主循环调用时，中断一看到INHIBITED就用的是新的起点
+ */
+static void TurnDetection_Inhibit(void)
+{
+    g_turnDetection.inhibit_start_distance = TurnDetection_Distance();
+    __asm volatile ("" ::: "memory");
+    g_turnDetection.state = TURN_STATE_INHIBITED;
+}
+
+/**
+ * @brief 发布路口事件
+ * @param type 路口类型
+ * @note 队列满时丢弃最新事件
+ */
+static void TurnDetection_PushEvent(Junction_Type_t type)
+{
+    uint8_t head = eventHead;
+    if ((uint8_t)(head - eventTail) >= JUNCTION_EVENT_QUEUE_SIZE) {
+        return;
+    }
+    eventQueue[head & (JUNCTION_EVENT_QUEUE_SIZE - 1)].type = type;
+    eventQueue[head & (JUNCTION_EVENT_QUEUE_SIZE - 1)].timestamp_ms = tick_ms;
+    eventQueue[head & (JUNCTION_EVENT_QUEUE_SIZE - 1)].distance = TurnDetection_Distance();
+    __asm volatile ("" ::: "memory");
+    eventHead = head + 1;
+}
+
+/**
+ * @brief 按目前出现过的分支给出暂定的转弯类型
+ */
+static Junction_Type_t TurnDetection_ProvisionalType(void)
+{
+    if (g_turnDetection.saw_left && g_turnDetection.saw_right) {
+        return JUNCTION_T;
+    }
+    return g_turnDetection.saw_left ? JUNCTION_LEFT : JUNCTION_RIGHT;
+}
+
+/**
+ * @brief 撤销暂定的转弯提示（分类结果为可直行通过或放弃分类）
+ */
+static void TurnDetection_Withdraw(void)
+{
+    g_turnDetection.turn_ready = false;
+    g_turnDetection.turn_type = JUNCTION_NONE;
+}
+
+/**
+ * @brief 分类窗口结束，查表得到路口类型并发布
+ */
+static void TurnDetection_Classify(void)
+{
+    uint8_t index = (g_turnDetection.saw_left ? 1 : 0) |
+                    (g_turnDetection.saw_right ? 2 : 0) |
+                    (g_turnDetection.saw_straight ? 4 : 0);
+    Junction_Type_t type = junctionTable[index];
+
+    if (type == JUNCTION_NONE) {
+        TurnDetection_Withdraw();
+        g_turnDetection.state = TURN_STATE_IDLE;
+        return;
+    }
+
+    TurnDetection_PushEvent(type);
+
+    if (type == JUNCTION_LEFT || type == JUNCTION_RIGHT || type == JUNCTION_T) {
+        // 必须转弯的路口：等待上层处理后调用TurnDetection_Reset
+        g_turnDetection.state = TURN_STATE_CONFIRMED;
+        g_turnDetection.turn_type = type;
+        g_turnDetection.turn_ready = true;
+        g_turnDetection.turn_confirmed = true;
+    } else {
+        // 可直行通过的路口：撤销暂定提示，抑制一段距离防止重复检测
+        TurnDetection_Withdraw();
+        TurnDetection_Inhibit();
+    }
+}
+
 /**
  * @brief 初始化转弯检测模块
  */
@@ -14,11 +144,23 @@ void TurnDetection_Init(void)
     // 清空数据结构
     g_turnDetection.state = TURN_STATE_IDLE;
     g_turnDetection.left_sensor_count = 0;
-    g_turnDetection.detect_start_time = 0;
-    g_turnDetection.inhibit_start_time = 0;
-    g_turnDetection.last_turn_time = 0;
+    g_turnDetection.right_sensor_count = 0;
+    g_turnDetection.arm_active = false;
+    g_turnDetection.saw_left = false;
+    g_turnDetection.saw_right = false;
+    g_turnDetection.saw_straight = false;
+    g_turnDetection.arm_start_distance = 0;
+    g_turnDetection.detect_start_distance = 0;
+    g_turnDetection.lookahead_start_distance = 0;
+    g_turnDetection.lost_start_distance = 0;
+    g_turnDetection.lost_from_center = false;
+    g_turnDetection.inhibit_start_distance = 0;
+    g_turnDetection.turn_type = JUNCTION_NONE;
     g_turnDetection.turn_ready = false;
-    
+    g_turnDetection.turn_confirmed = false;
+    eventHead = 0;
+    eventTail = 0;
+
     // 启动TIMG8定时器用于转弯检测
     NVIC_EnableIRQ(TIMER_TRACKER_INST_INT_IRQN);
     DL_TimerG_startCounter(TIMER_TRACKER_INST);
@@ -26,89 +168,182 @@ void TurnDetection_Init(void)
 
 /**
  * @brief 更新转弯检测状态（应在定时器中断或主循环中定期调用）
+ * @note 路口分类过程：
+ *       1. 一侧≥TURN_DETECT_COUNT_MIN路传感器检测到线并持续TURN_DETECT_STABLE_MM -> 打开分类窗口，
+ *          同时立即置位turn_ready（类型按已出现的分支暂定），停车转向的调用者在这里停车，
+ *          停车位置与原来的一样早
+ *       2. 窗口内累积出现过的分支（左/右）
+ *       3. 分支消失后再行驶JUNCTION_LOOKAHEAD_MM，记录直行方向是否还有线
+ *       4. 以(左, 右, 直行)查表得到路口类型，带时间戳和里程放入事件队列；
+ *          必须转弯的路口置位turn_confirmed（不停车过弯等到这里），可直行通过的撤销turn_ready
+ *       另外，线从中间消失后行驶JUNCTION_END_MM仍无线判定为终点。
+ *       所有确认/抑制阈值都按编码器里程计算，不同车速下在赛道上的同一位置触发。
  */
 void TurnDetection_Update(void)
 {
-    // 更新传感器数据
+    // 更新传感器数据（本中断就是写者，可以直接读取）
     LineTracker_ReadSensors_Interrupt();
-    
-    // 检查是否在转弯抑制期内
-    bool turn_inhibited = (tick_ms - g_turnDetection.last_turn_time) < TURN_INHIBIT_TIME_MS;
-    if (turn_inhibited && g_turnDetection.state != TURN_STATE_INHIBITED) {
-        g_turnDetection.state = TURN_STATE_INHIBITED;
-        g_turnDetection.inhibit_start_time = tick_ms;
-    } else if (!turn_inhibited && g_turnDetection.state == TURN_STATE_INHIBITED) {
-        g_turnDetection.state = TURN_STATE_IDLE;
-    }
-    
-    // 检查左侧转弯条件：左侧3路传感器中有≥2路检测到线
-    uint8_t left_sensor_count = 0;
-    if (g_lineTracker.sensorValue[0]) left_sensor_count++; // 最左
-    if (g_lineTracker.sensorValue[1]) left_sensor_count++; // 左
-    if (g_lineTracker.sensorValue[2]) left_sensor_count++; // 中左
-    
-    g_turnDetection.left_sensor_count = left_sensor_count;
-    bool turn_condition = (left_sensor_count >= TURN_DETECT_COUNT_MIN) && !turn_inhibited;
-    
+    uint8_t bits = LineTracker_GetSensorBits();
+
+    // 分支检测
+    g_turnDetection.left_sensor_count = TurnDetection_CountBits(bits & JUNCTION_LEFT_MASK);
+    g_turnDetection.right_sensor_count = TurnDetection_CountBits(bits & JUNCTION_RIGHT_MASK);
+    bool left_arm = g_turnDetection.left_sensor_count >= TURN_DETECT_COUNT_MIN;
+    bool right_arm = g_turnDetection.right_sensor_count >= TURN_DETECT_COUNT_MIN;
+    bool center = (bits & JUNCTION_CENTER_MASK) != 0;
+
     switch (g_turnDetection.state) {
         case TURN_STATE_IDLE:
-            if (turn_condition) {
-                // 检测到转弯信号
-                g_turnDetection.state = TURN_STATE_DETECTED;
-                g_turnDetection.detect_start_time = tick_ms;
+            if (left_arm || right_arm) {
+                g_turnDetection.lost_from_center = false;
+                if (!g_turnDetection.arm_active) {
+                    g_turnDetection.arm_active = true;
+                    g_turnDetection.arm_start_distance = TurnDetection_Distance();
+                }
+                if (TurnDetection_Travelled(g_turnDetection.arm_start_distance) >= TURN_DETECT_STABLE_MM) {
+                    // 分支信号稳定，打开分类窗口
+                    g_turnDetection.state = TURN_STATE_DETECTED;
+                    g_turnDetection.detect_start_distance = g_turnDetection.arm_start_distance;
+                    g_turnDetection.saw_left = left_arm;
+                    g_turnDetection.saw_right = right_arm;
+                    g_turnDetection.saw_straight = false;
+                    g_turnDetection.turn_type = TurnDetection_ProvisionalType();
+                    g_turnDetection.turn_ready = true;
+                }
+                break;
+            }
+            g_turnDetection.arm_active = false;
+
+            // 终点检测：线从中间消失并行驶一段距离（急弯丢线时最后看到的是边缘传感器）
+            if (bits == 0) {
+                if (g_turnDetection.lost_from_center &&
+                    TurnDetection_Travelled(g_turnDetection.lost_start_distance) >= JUNCTION_END_MM) {
+                    g_turnDetection.lost_from_center = false;
+                    TurnDetection_PushEvent(JUNCTION_END);
+                    TurnDetection_Inhibit();
+                }
+            } else {
+                g_turnDetection.lost_from_center = center;
+                g_turnDetection.lost_start_distance = TurnDetection_Distance();
             }
             break;
-            
+
         case TURN_STATE_DETECTED:
-            if (!turn_condition) {
-                // 转弯信号消失，回到空闲状态
+        case TURN_STATE_LOOKAHEAD:
+            // 窗口过长（沿平行线行驶等），放弃本次分类
+            if (TurnDetection_Travelled(g_turnDetection.detect_start_distance) >= JUNCTION_WINDOW_MAX_MM) {
+                TurnDetection_Withdraw();
                 g_turnDetection.state = TURN_STATE_IDLE;
+                g_turnDetection.arm_active = false;
+                break;
+            }
+
+            if (left_arm || right_arm) {
+                // 分支仍在（或重新出现），继续累积
+                g_turnDetection.saw_left |= left_arm;
+                g_turnDetection.saw_right |= right_arm;
+                g_turnDetection.saw_straight = false;
+                g_turnDetection.state = TURN_STATE_DETECTED;
+                g_turnDetection.turn_type = TurnDetection_ProvisionalType();
+            } else if (g_turnDetection.state == TURN_STATE_DETECTED) {
+                // 分支消失，开始观察直行方向
+                g_turnDetection.state = TURN_STATE_LOOKAHEAD;
+                g_turnDetection.lookahead_start_distance = TurnDetection_Distance();
+                g_turnDetection.saw_straight = center;
             } else {
-                // 检查转弯信号是否稳定
-                uint32_t detect_duration = tick_ms - g_turnDetection.detect_start_time;
-                bool quick_confirm = (left_sensor_count >= 2);
-                bool stable_confirm = (detect_duration >= TURN_DETECT_STABLE_MS);
-                
-                // 如果转弯信号稳定，确认转弯
-                if (quick_confirm || stable_confirm) {
-                    g_turnDetection.state = TURN_STATE_CONFIRMED;
-                    g_turnDetection.turn_ready = true;
-                } else if (detect_duration >= TURN_DETECT_TIMEOUT_MS) {
-                    // 检测超时，回到空闲状态
-                    g_turnDetection.state = TURN_STATE_IDLE;
+                g_turnDetection.saw_straight |= center;
+                if (TurnDetection_Travelled(g_turnDetection.lookahead_start_distance) >= JUNCTION_LOOKAHEAD_MM) {
+                    TurnDetection_Classify();
+                    g_turnDetection.arm_active = false;
                 }
             }
             break;
-            
+
         case TURN_STATE_CONFIRMED:
             // 等待转弯被处理
             break;
-            
+
         case TURN_STATE_INHIBITED:
             // 检查抑制是否结束
-            if ((tick_ms - g_turnDetection.inhibit_start_time) >= TURN_INHIBIT_TIME_MS) {
+            if (TurnDetection_Travelled(g_turnDetection.inhibit_start_distance) >= TURN_INHIBIT_MM) {
                 g_turnDetection.state = TURN_STATE_IDLE;
+                g_turnDetection.arm_active = false;
+                g_turnDetection.lost_from_center = false;
             }
             break;
     }
 }
 
 /**
- * @brief 检查是否准备好转弯
+ * @brief 检查是否准备好转弯（分支信号稳定即返回true，供停车转向使用）
  * @return true表示准备好转弯，false表示未准备好
+ * @note 此时类型是暂定的；车继续行驶时分类可能改判为可直行通过的路口，届时撤销
  */
 bool TurnDetection_IsTurnReady(void)
 {
     return g_turnDetection.turn_ready;
 }
 
+/**
+ * @brief 检查转弯是否已由分类确认（供不停车过弯使用）
+ * @return true表示分类完成且为必须转弯的路口（左/右/T字）
+ */
+bool TurnDetection_IsTurnConfirmed(void)
+{
+    return g_turnDetection.turn_confirmed;
+}
+
+/**
+ * @brief 获取待处理的转弯类型
+ * @return JUNCTION_LEFT / JUNCTION_RIGHT / JUNCTION_T，没有待处理转弯时返回JUNCTION_NONE
+ * @note 确认前按已出现的分支暂定，确认后为分类结果（也以事件形式放入事件队列）
+ */
+Junction_Type_t TurnDetection_GetTurnType(void)
+{
+    return g_turnDetection.turn_ready ? g_turnDetection.turn_type : JUNCTION_NONE;
+}
+
+/**
+ * @brief 获取传感器已越过待处理路口的距离
+ * @return 从分支信号第一次出现到现在的行驶距离（mm），没有待处理转弯时返回0
+ * @note 路口要等分类窗口和直行观察结束才确认，确认时传感器已经越过分支线，
+ *       圆弧过弯用它推算车轴离转角还有多远
+ */
+float TurnDetection_GetTurnOvershoot(void)
+{
+    if (!g_turnDetection.turn_ready) {
+        return 0.0f;
+    }
+    return TurnDetection_Travelled(g_turnDetection.detect_start_distance);
+}
+
+/**
+ * @brief 从事件队列取出一个路口事件
+ * @param event 输出事件
+ * @return true表示取到事件，false表示队列为空
+ */
+bool TurnDetection_PollEvent(Junction_Event_t *event)
+{
+    uint8_t tail = eventTail;
+    if (tail == eventHead) {
+        return false;
+    }
+    *event = eventQueue[tail & (JUNCTION_EVENT_QUEUE_SIZE - 1)];
+    __asm volatile ("" ::: "memory");
+    eventTail = tail + 1;
+    return true;
+}
+
 /**
  * @brief 重置转弯检测状态（在完成转弯后调用）
+ * @note 在主循环中调用，分类可能还在进行：先进入抑制状态让中断不再改写标志，再清标志，
+ *       否则中断在两步之间完成分类会重新置位turn_ready，造成第二次转弯
  */
 void TurnDetection_Reset(void)
 {
-    g_turnDetection.state = TURN_STATE_INHIBITED;
+    TurnDetection_Inhibit();
+    __asm volatile ("" ::: "memory");
     g_turnDetection.turn_ready = false;
-    g_turnDetection.last_turn_time = tick_ms;
-    g_turnDetection.inhibit_start_time = tick_ms;
-}
\ No newline at end of file
+    g_turnDetection.turn_confirmed = false;
+    g_turnDetection.turn_type = JUNCTION_NONE;
+}
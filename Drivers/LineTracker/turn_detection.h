@@ -4,28 +4,66 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-// 转弯检测参数
-#define TURN_DETECT_COUNT_MIN 3       // 最少检测到的左侧传感器数量
-#define TURN_DETECT_STABLE_MS 2       // 转弯信号稳定时间（毫秒）
-#define TURN_DETECT_TIMEOUT_MS 100    // 转弯检测最大等待时间
-#define TURN_INHIBIT_TIME_MS 800      // 转弯后的抑制时间（防止重复检测）
+// 路口分类用的传感器分组（bit0=最左边传感器）
+#define JUNCTION_LEFT_MASK    0x07    // 左侧三路（传感器0-2）
+#define JUNCTION_RIGHT_MASK   0x70    // 右侧三路（传感器4-6）
+#define JUNCTION_CENTER_MASK  0x1C    // 中间三路（传感器2-4）
+
+// 转弯检测参数（均按编码器里程计算，与车速无关，单位mm）
+#define TURN_DETECT_COUNT_MIN 3       // 一侧至少检测到的传感器数量（算作分支）
+#define TURN_DETECT_STABLE_MM 2       // 分支信号需持续的行驶距离
+#define JUNCTION_LOOKAHEAD_MM 5       // 分支消失后观察直行方向是否有线的距离
+#define JUNCTION_WINDOW_MAX_MM 60     // 分类窗口最长距离（超过则放弃，如沿平行线行驶）
+#define JUNCTION_END_MM 30            // 从中间丢线后行驶多远判定为线的终点
+#define TURN_INHIBIT_MM 150           // 转弯后的抑制距离（防止重复检测）
+#define JUNCTION_EVENT_QUEUE_SIZE 8   // 事件队列长度（必须是2的幂）
 
 // 转弯检测状态
 typedef enum {
     TURN_STATE_IDLE,           // 空闲状态
-    TURN_STATE_DETECTED,       // 检测到转弯信号
-    TURN_STATE_CONFIRMED,      // 转弯信号已确认
+    TURN_STATE_DETECTED,       // 检测到分支信号，正在累积分类窗口
+    TURN_STATE_LOOKAHEAD,      // 分支已消失，观察直行方向
+    TURN_STATE_CONFIRMED,      // 转弯已确认（分类完成），等待处理
     TURN_STATE_INHIBITED       // 抑制状态
 } Turn_State_t;
 
+// 路口类型
+typedef enum {
+    JUNCTION_NONE = 0,         // 无（噪声）
+    JUNCTION_LEFT,             // 左转弯（直行方向无线）
+    JUNCTION_RIGHT,            // 右转弯（直行方向无线）
+    JUNCTION_T,                // T字路口（左右都有线，直行方向无线）
+    JUNCTION_LEFT_BRANCH,      // 左侧岔路（直行继续）
+    JUNCTION_RIGHT_BRANCH,     // 右侧岔路（直行继续）
+    JUNCTION_CROSS,            // 十字路口
+    JUNCTION_END               // 线的终点
+} Junction_Type_t;
+
+// 路口事件
+typedef struct {
+    Junction_Type_t type;            // 路口类型
+    uint32_t timestamp_ms;           // 分类完成时间
+    int32_t distance;                // 分类完成时的里程（两轮编码器平均计数）
+} Junction_Event_t;
+
 // 转弯检测结构体
 typedef struct {
     Turn_State_t state;              // 当前状态
     uint8_t left_sensor_count;       // 左侧传感器检测数量
-    uint32_t detect_start_time;      // 检测开始时间
-    uint32_t inhibit_start_time;     // 抑制开始时间
-    uint32_t last_turn_time;         // 上次转弯时间
-    bool turn_ready;                 // 转弯准备就绪标志
+    uint8_t right_sensor_count;      // 右侧传感器检测数量
+    bool arm_active;                 // 分支信号正在出现
+    bool saw_left;                   // 窗口内出现过左分支
+    bool saw_right;                  // 窗口内出现过右分支
+    bool saw_straight;               // 分支消失后直行方向有线
+    int32_t arm_start_distance;      // 分支信号出现时的里程
+    int32_t detect_start_distance;   // 分类窗口开始里程
+    int32_t lookahead_start_distance;// 开始观察直行方向的里程
+    int32_t lost_start_distance;     // 开始丢线的里程
+    bool lost_from_center;           // 丢线前线在中间
+    int32_t inhibit_start_distance;  // 抑制开始里程
+    Junction_Type_t turn_type;       // 待处理的转弯类型（确认前为按已出现分支暂定的类型）
+    bool turn_ready;                 // 转弯准备就绪标志（分支信号稳定即置位）
+    bool turn_confirmed;             // 分类完成，确认为必须转弯的路口
 } Turn_Detection_t;
 
 // 全局变量声明
@@ -35,6 +73,10 @@ extern Turn_Detection_t g_turnDetection;
 void TurnDetection_Init(void);
 void TurnDetection_Update(void);
 bool TurnDetection_IsTurnReady(void);
+bool TurnDetection_IsTurnConfirmed(void);
+Junction_Type_t TurnDetection_GetTurnType(void);
+bool TurnDetection_PollEvent(Junction_Event_t *event);
+float TurnDetection_GetTurnOvershoot(void);
 void TurnDetection_Reset(void);
 
-#endif /* TURN_DETECTION_H */
\ No newline at end of file
+#endif /* TURN_DETECTION_H */
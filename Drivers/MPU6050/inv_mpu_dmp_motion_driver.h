@@ -93,5 +93,12 @@ int dmp_enable_gyro_cal(unsigned char enable);
 int dmp_read_fifo(short *gyro, short *accel, long *quat,
     unsigned long *timestamp, short *sensors, unsigned char *more);
 
+/* Split read: the caller fetches packets from the FIFO itself (e.g. with an
+ * interrupt driven I2C transfer) and only uses the driver to decode them.
+ */
+int dmp_get_packet_length(unsigned char *length);
+int dmp_decode_fifo(const unsigned char *fifo_data, short *gyro, short *accel,
+    long *quat, short *sensors);
+
 #endif  /* #ifndef _INV_MPU_DMP_MOTION_DRIVER_H_ */
 
@@ -10,6 +10,9 @@
 
 #include "mpu6050.h"
 #include "mspm0_i2c.h"
+#include "clock.h"
+#include "seqlock.h"
+#include "fast_math.h"
 
 /* Data requested by client. */
 #define PRINT_ACCEL     (0x01)
@@ -25,6 +28,13 @@
 /* Starting sampling rate. */
 #define DEFAULT_MPU_HZ  (50)
 
+/* FIFO direct access (the INT handler reads the FIFO asynchronously). */
+#define MPU6050_ADDR            (0x68)
+#define MPU6050_REG_FIFO_COUNTH (0x72)
+#define MPU6050_REG_FIFO_R_W    (0x74)
+#define MPU6050_FIFO_SIZE       (1024)
+#define MPU6050_PACKET_MAX      (32)
+
 #define FLASH_SIZE      (512)
 #define FLASH_MEM_START ((void*)0x1800)
 
@@ -49,9 +59,38 @@ short gyro[3], accel[3], sensors;
 unsigned char more;
 long quat[4];
 
-#define q30  (1073741824.0f) /* 2^30 = 1073741824 */
+#define Q30_TO_FLOAT  (1.0f / 1073741824.0f) /* 1 / 2^30，乘法代替除法 */
 float pitch, roll, yaw;
 
+/* FIFO读取链：INT中断（上半部）只锁存时间戳并提交异步I2C读取，
+ * I2C完成回调依次读出FIFO计数和数据包，把最新的一包放进快照；
+ * Read_Quad（下半部）从快照解码姿态，整个过程中断里没有阻塞等待。
+ */
+typedef enum {
+    FIFO_CHAIN_IDLE = 0,        // 没有进行中的读取
+    FIFO_CHAIN_COUNT,           // 正在读FIFO计数
+    FIFO_CHAIN_PACKET           // 正在读一个数据包
+} fifo_chain_state_t;
+
+static I2C_Xfer_t fifo_xfer;
+static volatile fifo_chain_state_t fifo_state;
+static volatile bool fifo_int_pending;      // 读取过程中又来了INT，结束后重新读计数
+static volatile uint32_t fifo_int_ms;       // 最近一次INT的时间
+static volatile bool fifo_reset_request;    // FIFO溢出或数据包损坏，由MPU6050_Service在主循环中复位
+static uint8_t fifo_rx[MPU6050_PACKET_MAX];
+static uint16_t fifo_left;                  // FIFO中还未读出的字节数
+static uint8_t fifo_packet_len;             // DMP数据包长度
+
+// 最新数据包快照（I2C中断写，下半部读）
+static struct {
+    uint8_t packet[MPU6050_PACKET_MAX];
+    uint32_t timestamp_ms;                  // 对应INT的时间
+    uint8_t more;                           // 之后FIFO中还剩的包数
+    uint32_t count;                         // 累计收到的包数
+} fifo_latest;
+static seqlock_t fifo_latest_lock;
+static uint32_t fifo_decoded_count;         // 下半部已解码到的包数
+
 /* The sensors can be mounted onto the board in any orientation. The mounting
  * matrix seen below tells the MPL how to rotate the raw data from thei
  * driver(s).
@@ -191,48 +230,185 @@ void MPU6050_Init(void)
     result += dmp_enable_feature(hal.dmp_features);
     result += dmp_set_fifo_rate(DEFAULT_MPU_HZ);
     result += mpu_set_dmp_state(1);
-    hal.dmp_on = 1;
+    result += dmp_get_packet_length(&fifo_packet_len);
 
-    if (result)
+    if (result || fifo_packet_len == 0 || fifo_packet_len > MPU6050_PACKET_MAX)
         DL_SYSCTL_resetDevice(DL_SYSCTL_RESET_POR);
 
+    fifo_state = FIFO_CHAIN_IDLE;
+    fifo_int_pending = false;
+    fifo_reset_request = false;
+    fifo_decoded_count = fifo_latest.count;
+    hal.dmp_on = 1;
+
     /* Enable INT_GROUP1 handler. */
     NVIC_EnableIRQ(1);
 }
 
+static void fifo_read_done(I2C_Xfer_t *xfer);
+
+/**
+ * @brief 提交一次FIFO寄存器读取（写寄存器地址后重复起始读）
+ */
+static void fifo_submit(fifo_chain_state_t state, uint8_t reg, uint16_t len)
+{
+    fifo_state = state;
+    fifo_xfer.addr = MPU6050_ADDR;
+    fifo_xfer.hdr_len = 1;
+    fifo_xfer.hdr[0] = reg;
+    fifo_xfer.tx = NULL;
+    fifo_xfer.tx_len = 0;
+    fifo_xfer.rx = fifo_rx;
+    fifo_xfer.rx_len = len;
+    fifo_xfer.done = fifo_read_done;
+    if (!I2C_Bus_Submit(mpu6050_i2c_bus(), &fifo_xfer))
+        fifo_state = FIFO_CHAIN_IDLE;
+}
+
+/**
+ * @brief 读取链的下一步（在I2C中断中调用）
+ * @note 先读FIFO计数，再逐包读出，只保留最新的一包；
+ *       读取过程中来的INT在链结束后补读一次计数
+ */
+static void fifo_read_done(I2C_Xfer_t *xfer)
+{
+    if (xfer->status != I2C_XFER_DONE) {
+        fifo_left = 0;
+    } else if (fifo_state == FIFO_CHAIN_COUNT) {
+        fifo_left = ((uint16_t)fifo_rx[0] << 8) | fifo_rx[1];
+        if (fifo_left >= MPU6050_FIFO_SIZE) {
+            /* FIFO已溢出，数据包边界不可信 */
+            fifo_left = 0;
+            fifo_reset_request = true;
+        }
+    } else {
+        fifo_left -= fifo_packet_len;
+        seqlock_write_begin(&fifo_latest_lock);
+        memcpy(fifo_latest.packet, fifo_rx, fifo_packet_len);
+        fifo_latest.timestamp_ms = fifo_int_ms;
+        fifo_latest.more = fifo_left / fifo_packet_len;
+        fifo_latest.count++;
+        seqlock_write_end(&fifo_latest_lock);
+    }
+
+    if (fifo_left >= fifo_packet_len) {
+        fifo_submit(FIFO_CHAIN_PACKET, MPU6050_REG_FIFO_R_W, fifo_packet_len);
+        return;
+    }
+
+    fifo_state = FIFO_CHAIN_IDLE;
+    if (fifo_int_pending) {
+        fifo_int_pending = false;
+        fifo_submit(FIFO_CHAIN_COUNT, MPU6050_REG_FIFO_COUNTH, 2);
+    }
+}
+
+/**
+ * @brief MPU6050 INT中断（上半部），在GROUP1中断中调用
+ * @note 只记录时间戳并启动异步读取，立即返回，不影响同一中断里的编码器处理。
+ *       先置pending再检查状态：如果读取链恰好在两者之间结束，完成回调会看到pending并补读。
+ */
+void MPU6050_IRQHandler(void)
+{
+    if (!hal.dmp_on)
+        return;
+
+    fifo_int_ms = tick_ms;
+    fifo_int_pending = true;
+    if (fifo_state == FIFO_CHAIN_IDLE) {
+        fifo_int_pending = false;
+        fifo_submit(FIFO_CHAIN_COUNT, MPU6050_REG_FIFO_COUNTH, 2);
+    }
+}
+
+/**
+ * @brief 检查数据包中的四元数模长（与dmp_decode_fifo的FIFO_CORRUPTION_CHECK阈值相同）
+ * @note 提前在这里检查，损坏的包不交给dmp_decode_fifo，避免它在中断里同步复位FIFO
+ */
+static bool mpu6050_packet_valid(const uint8_t *packet)
+{
+    long q14, mag_sq = 0;
+    uint8_t i;
+
+    for (i = 0; i < 4; i++) {
+        q14 = (short)(((uint16_t)packet[4 * i] << 8) | packet[4 * i + 1]);
+        mag_sq += q14 * q14;
+    }
+    return mag_sq >= (1L << 28) - (1L << 24) && mag_sq <= (1L << 28) + (1L << 24);
+}
+
+/**
+ * @brief MPU6050主循环服务：检查FIFO读取链超时，执行下半部请求的FIFO复位
+ * @note 两者都会访问总线并可能延时（SDA解锁最长约200ms，复位FIFO约8次阻塞写），
+ *       只能在主循环中调用，不能放进控制中断
+ */
+void MPU6050_Service(void)
+{
+    if (!hal.dmp_on)
+        return;
+
+    /* 读取链卡住时由引擎超时恢复（解锁SDA），回调以失败状态结束读取链 */
+    I2C_Bus_CheckTimeout(mpu6050_i2c_bus());
+
+    if (fifo_reset_request) {
+        /* 复位期间忽略INT，等进行中的读取链结束后再复位，避免读到复位前后拼接的数据 */
+        hal.dmp_on = 0;
+        while (fifo_state != FIFO_CHAIN_IDLE)
+            I2C_Bus_CheckTimeout(mpu6050_i2c_bus());
+        fifo_reset_request = false;
+        fifo_int_pending = false;
+        mpu_reset_fifo();
+        hal.dmp_on = 1;
+    }
+}
+
+/**
+ * @brief 解码最新的FIFO数据包（下半部）
+ * @return 0表示得到新的姿态，-1表示没有新数据或数据无效
+ * @note 在使用姿态的上下文中调用（TIMA1控制中断或主循环），不访问总线；
+ *       FIFO溢出或数据包损坏时只置复位请求，由MPU6050_Service在主循环中复位
+ */
 int Read_Quad(void)
 {
-    /* This function gets new data from the FIFO when the DMP is in
-    * use. The FIFO can contain any combination of gyro, accel,
-    * quaternion, and gesture data. The sensors parameter tells the
-    * caller which data fields were actually populated with new data.
-    * For example, if sensors == (INV_XYZ_GYRO | INV_WXYZ_QUAT), then
-    * the FIFO isn't being filled with accel data.
-    * The driver parses the gesture data to determine if a gesture
-    * event has occurred; on an event, the application will be notified
-    * via a callback (assuming that a callback function was properly
-    * registered). The more parameter is non-zero if there are
-    * leftover packets in the FIFO.
-    */
+    uint8_t packet[MPU6050_PACKET_MAX];
+    uint32_t count, timestamp_ms, seq;
+    uint8_t left;
 
-    int result;
+    if (!hal.dmp_on || fifo_reset_request)
+        return -1;
 
-    do
-    {
-        result = dmp_read_fifo(gyro, accel, quat, &sensor_timestamp, &sensors, &more);
-    }while(more);
+    do {
+        seq = seqlock_read_begin(&fifo_latest_lock);
+        count = fifo_latest.count;
+        timestamp_ms = fifo_latest.timestamp_ms;
+        left = fifo_latest.more;
+        memcpy(packet, fifo_latest.packet, fifo_packet_len);
+    } while (seqlock_read_retry(&fifo_latest_lock, seq));
 
-    if(result)
+    if (count == fifo_decoded_count)
         return -1;
+    fifo_decoded_count = count;
 
-    float q0 = quat[0] / q30;
-    float q1 = quat[1] / q30;
-    float q2 = quat[2] / q30;
-    float q3 = quat[3] / q30;
+    if (!mpu6050_packet_valid(packet)) {
+        fifo_reset_request = true;
+        return -1;
+    }
 
-    pitch  = asin(-2 * q1 * q3 + 2 * q0 * q2) * 57.3;
-    roll   = atan2(2 * q2 * q3 + 2 * q0 * q1, -2 * q1 * q1 - 2 * q2 * q2 + 1) * 57.3;
-    yaw    = atan2(2 * (q1 * q2 + q0 * q3), q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3) * 57.3;
+    if (dmp_decode_fifo(packet, gyro, accel, quat, &sensors))
+        return -1;
+    sensor_timestamp = timestamp_ms;
+    more = left;
+
+    float q0 = quat[0] * Q30_TO_FLOAT;
+    float q1 = quat[1] * Q30_TO_FLOAT;
+    float q2 = quat[2] * Q30_TO_FLOAT;
+    float q3 = quat[3] * Q30_TO_FLOAT;
+
+#if MPU6050_YAW_ONLY
+    FastMath_QuatToEuler(q0, q1, q2, q3, NULL, NULL, &yaw);
+#else
+    FastMath_QuatToEuler(q0, q1, q2, q3, &roll, &pitch, &yaw);
+#endif
 
     return 0;
 }
\ No newline at end of file
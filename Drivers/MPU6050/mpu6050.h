@@ -16,15 +16,26 @@
  *     7. Set "Interrupt Priority" to "Level 1 - High" or lower.
  *     8. Set "Trigger Polarity" to "Trigger on Falling Edge".
  *     9. Set the pin according to your needs.
+ *
+ * INT中断只调用MPU6050_IRQHandler锁存时间戳并启动异步FIFO读取（共享I2C引擎），
+ * 姿态由Read_Quad在使用它的上下文中解码（默认在TIMA1控制中断开头调用）。
+ * 需要访问总线的读取链超时恢复和FIFO复位由MPU6050_Service完成，须在主循环中定期调用。
  */
 
 #ifndef _MPU6050_H_
 #define _MPU6050_H_
 
+// 1：Read_Quad只计算yaw（pitch/roll保持不变），循迹小车只用到yaw；0：三个角都计算
+#ifndef MPU6050_YAW_ONLY
+#define MPU6050_YAW_ONLY    0
+#endif
+
 extern short gyro[3], accel[3];
 extern float pitch, roll, yaw;
 
 void MPU6050_Init(void);
+void MPU6050_IRQHandler(void);
 int Read_Quad(void);
+void MPU6050_Service(void);
 
 #endif  /* #ifndef _MPU6050_H_ */
\ No newline at end of file
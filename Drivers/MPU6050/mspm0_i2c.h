@@ -1,6 +1,9 @@
 #ifndef _MSPM0_I2C_H_
 #define _MSPM0_I2C_H_
 
+#include "i2c_bus.h"
+
+I2C_Bus_t *mpu6050_i2c_bus(void);
 void mpu6050_i2c_sda_unlock(void);
 
 int mspm0_i2c_write(unsigned char slave_addr,
@@ -19,6 +19,24 @@ int mspm0_get_clock_ms(unsigned long *count)
     return 0;
 }
 
+/**
+ * 获取以CPU时钟周期为单位的自由运行时间戳
+ * 由tick_ms和SysTick当前值拼接，32位回绕周期约为 2^32 / CPUCLK_FREQ 秒（80MHz下约53秒），
+ * 只适合用无符号差值计算短时间间隔。SysTick优先级最高，若读取期间tick_ms变化则重读。
+ */
+uint32_t mspm0_get_clock_cycles(void)
+{
+    unsigned long ms;
+    uint32_t val;
+
+    do {
+        ms = tick_ms;
+        val = SysTick->VAL;
+    } while (ms != tick_ms);
+
+    return (uint32_t)ms * (CPUCLK_FREQ / 1000) + (CPUCLK_FREQ / 1000 - 1 - val);
+}
+
 void SysTick_Init(void)
 {
     DL_SYSTICK_config(CPUCLK_FREQ/1000);
@@ -1,10 +1,13 @@
 #ifndef _CLOCK_H_
 #define _CLOCK_H_
 
+#include <stdint.h>
+
 extern volatile unsigned long tick_ms;
 
 int mspm0_delay_ms(unsigned long num_ms);
 int mspm0_get_clock_ms(unsigned long *count);
+uint32_t mspm0_get_clock_cycles(void);
 void SysTick_Init(void);
 
 #endif  /* #ifndef _CLOCK_H_ */
\ No newline at end of file
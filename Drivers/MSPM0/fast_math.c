@@ -0,0 +1,94 @@
+#include "fast_math.h"
+#include <math.h>
+#include <stddef.h>
+
+// atan(z), z∈[0,1] 的奇次多项式系数（最大误差约2e-6 rad）
+#define ATAN_C1     0.99997726f
+#define ATAN_C3    -0.33262347f
+#define ATAN_C5     0.19354346f
+#define ATAN_C7    -0.11643287f
+#define ATAN_C9     0.05265332f
+#define ATAN_C11   -0.01172120f
+
+/**
+ * @brief 快速atan2（奇次多项式）
+ * @param y 纵坐标
+ * @param x 横坐标
+ * @return 弧度，范围[-π, π]，x = y = 0时返回0
+ * @note 只有一次除法；比值始终取小/大，保证多项式输入在[0,1]内
+ */
+float FastMath_Atan2(float y, float x)
+{
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    float z, z2, r;
+
+    if (ax == 0.0f && ay == 0.0f) {
+        return 0.0f;
+    }
+
+    z = (ay > ax) ? ax / ay : ay / ax;
+    z2 = z * z;
+    r = z * (ATAN_C1 + z2 * (ATAN_C3 + z2 * (ATAN_C5 + z2 * (ATAN_C7 + z2 * (ATAN_C9 + z2 * ATAN_C11)))));
+
+    if (ay > ax) {
+        r = FAST_MATH_HALF_PI - r;
+    }
+    if (x < 0.0f) {
+        r = FAST_MATH_PI - r;
+    }
+    return (y < 0.0f) ? -r : r;
+}
+
+/**
+ * @brief 单精度开方
+ */
+float FastMath_Sqrt(float x)
+{
+    return (x > 0.0f) ? sqrtf(x) : 0.0f;
+}
+
+/**
+ * @brief 单精度除法
+ */
+float FastMath_Div(float num, float den)
+{
+    return num / den;
+}
+
+/**
+ * @brief 快速asin
+ * @param x 正弦值，超出[-1, 1]时钳位（四元数未严格归一化时会略超出）
+ * @return 弧度，范围[-π/2, π/2]
+ */
+float FastMath_Asin(float x)
+{
+    if (x >= 1.0f) {
+        return FAST_MATH_HALF_PI;
+    }
+    if (x <= -1.0f) {
+        return -FAST_MATH_HALF_PI;
+    }
+    return FastMath_Atan2(x, FastMath_Sqrt((1.0f - x) * (1.0f + x)));
+}
+
+/**
+ * @brief 四元数转欧拉角（ZYX顺序）
+ * @param w,x,y,z 单位四元数
+ * @param roll  输出横滚角（度），NULL表示不需要
+ * @param pitch 输出俯仰角（度），NULL表示不需要
+ * @param yaw   输出偏航角（度），NULL表示不需要
+ */
+void FastMath_QuatToEuler(float w, float x, float y, float z,
+                          float *roll, float *pitch, float *yaw)
+{
+    if (roll) {
+        *roll = FastMath_Atan2(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)) * FAST_MATH_RAD2DEG;
+    }
+    if (pitch) {
+        *pitch = FastMath_Asin(2.0f * (w * y - z * x)) * FAST_MATH_RAD2DEG;
+    }
+    if (yaw) {
+        *yaw = FastMath_Atan2(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)) * FAST_MATH_RAD2DEG;
+    }
+}
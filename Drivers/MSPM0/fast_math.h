@@ -0,0 +1,32 @@
+/*
+ * fast_math.h
+ *
+ *  单精度快速数学函数 - 姿态解算、速度换算用（M0+没有FPU，libm的atan2/asin/sqrt/除法全是软件实现）
+ *
+ *  可移植C实现，目标板和主机相同：atan2为11阶奇次多项式，全周最大误差约2e-6 rad（1.2e-4°）；
+ *  sqrt/除法用标准C（集中在这里，以后换实现时调用者不用改）。
+ *
+ *  - FastMath_Atan2 / FastMath_Asin：弧度；asin(x) = atan2(x, sqrt((1-x)(1+x)))，|x|>1时钳位
+ *  - FastMath_Sqrt / FastMath_Div：单精度开方、除法
+ *  - FastMath_QuatToEuler：四元数转欧拉角（ZYX顺序，单位：度），不需要的输出传NULL即跳过计算，
+ *    只要yaw时只做一次atan2
+ *
+ *  精度由主机测试Test/host/test_fast_math.c检查（make -C Test/host）；
+ *  板上的精度和耗时对比见Test/test.c中的Test_FastMath_Accuracy。
+ */
+
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+
+#define FAST_MATH_PI        3.14159265f
+#define FAST_MATH_HALF_PI   1.57079633f
+#define FAST_MATH_RAD2DEG   57.2957795f
+
+float FastMath_Atan2(float y, float x);
+float FastMath_Asin(float x);
+float FastMath_Sqrt(float x);
+float FastMath_Div(float num, float den);
+void FastMath_QuatToEuler(float w, float x, float y, float z,
+                          float *roll, float *pitch, float *yaw);
+
+#endif  /* #ifndef _FAST_MATH_H_ */
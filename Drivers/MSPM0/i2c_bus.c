@@ -0,0 +1,523 @@
+#include "i2c_bus.h"
+#include "clock.h"
+#include <string.h>
+
+// 引擎常开的中断（TX FIFO阈值中断只在有数据待补发时打开）
+#define I2C_BUS_INTERRUPTS (DL_I2C_INTERRUPT_CONTROLLER_TX_DONE |           \
+                            DL_I2C_INTERRUPT_CONTROLLER_RX_DONE |           \
+                            DL_I2C_INTERRUPT_CONTROLLER_NACK |              \
+                            DL_I2C_INTERRUPT_CONTROLLER_ARBITRATION_LOST |  \
+                            DL_I2C_INTERRUPT_CONTROLLER_RXFIFO_TRIGGER)
+
+// 启动传输前等待上一次STOP发完的最大轮询次数（总线卡死时交给超时恢复处理）
+#define I2C_BUS_IDLE_SPIN   1000
+
+#define I2C_BUS_INDEX(inst) ((inst) == I2C0 ? 0 : 1)
+
+static I2C_Bus_t g_i2cBus[I2C_BUS_COUNT];
+static volatile bool g_i2cRecovering[I2C_BUS_COUNT];
+static volatile bool g_i2cUnlockPending[I2C_BUS_COUNT];    // 中断中超时只复位了外设，SDA解锁留给主循环
+
+// 临界区：队列可能同时被主循环、定时器中断和I2C中断修改
+static inline uint32_t I2C_Bus_Lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static inline void I2C_Bus_Unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+static void I2C_Bus_Disable(const I2C_Bus_Config_t *cfg)
+{
+    DL_I2C_reset(cfg->inst);
+    DL_GPIO_initDigitalOutput(cfg->scl_iomux);
+    DL_GPIO_initDigitalInputFeatures(cfg->sda_iomux,
+		 DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_NONE,
+		 DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
+    DL_GPIO_clearPins(cfg->scl_port, cfg->scl_pin);
+    DL_GPIO_enableOutput(cfg->scl_port, cfg->scl_pin);
+}
+
+static void I2C_Bus_Enable(const I2C_Bus_Config_t *cfg)
+{
+    DL_I2C_reset(cfg->inst);
+    DL_GPIO_initPeripheralInputFunctionFeatures(cfg->sda_iomux,
+        cfg->sda_iomux_func, DL_GPIO_INVERSION_DISABLE,
+        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
+        DL_GPIO_WAKEUP_DISABLE);
+    DL_GPIO_initPeripheralInputFunctionFeatures(cfg->scl_iomux,
+        cfg->scl_iomux_func, DL_GPIO_INVERSION_DISABLE,
+        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
+        DL_GPIO_WAKEUP_DISABLE);
+    DL_GPIO_enableHiZ(cfg->sda_iomux);
+    DL_GPIO_enableHiZ(cfg->scl_iomux);
+    DL_I2C_enablePower(cfg->inst);
+    cfg->init();
+}
+
+/**
+ * @brief 解锁被从机拉低的SDA：SCL切换为GPIO输出时钟，直到从机释放SDA，再恢复外设
+ */
+static void I2C_Bus_SdaUnlock(const I2C_Bus_Config_t *cfg)
+{
+    uint8_t cycleCnt = 0;
+    I2C_Bus_Disable(cfg);
+    do
+    {
+        DL_GPIO_clearPins(cfg->scl_port, cfg->scl_pin);
+        mspm0_delay_ms(1);
+        DL_GPIO_setPins(cfg->scl_port, cfg->scl_pin);
+        mspm0_delay_ms(1);
+
+        if(DL_GPIO_readPins(cfg->sda_port, cfg->sda_pin))
+            break;
+    }while(++cycleCnt < 100);
+    I2C_Bus_Enable(cfg);
+}
+
+/**
+ * @brief 配置FIFO阈值并打开引擎使用的中断（外设初始化/恢复后调用）
+ */
+static void I2C_Bus_SetupInterrupts(const I2C_Bus_Config_t *cfg)
+{
+    DL_I2C_setControllerTXFIFOThreshold(cfg->inst, DL_I2C_TX_FIFO_LEVEL_BYTES_1);
+    DL_I2C_setControllerRXFIFOThreshold(cfg->inst, DL_I2C_RX_FIFO_LEVEL_BYTES_1);
+    DL_I2C_disableInterrupt(cfg->inst, 0xFFFFFFFF);
+    DL_I2C_clearInterruptStatus(cfg->inst, 0xFFFFFFFF);
+    DL_I2C_enableInterrupt(cfg->inst, I2C_BUS_INTERRUPTS);
+    NVIC_ClearPendingIRQ(cfg->irqn);
+    NVIC_EnableIRQ(cfg->irqn);
+}
+
+/**
+ * @brief 启动队列头的传输（调用时总线空闲，且在临界区或I2C中断中）
+ */
+static void I2C_Bus_Start(I2C_Bus_t *bus)
+{
+    const I2C_Bus_Config_t *cfg = bus->cfg;
+    I2C_Regs *inst = cfg->inst;
+    I2C_Xfer_t *x = bus->head;
+    uint16_t spin = 0;
+
+    if (x == NULL || g_i2cRecovering[I2C_BUS_INDEX(inst)]) {
+        return;
+    }
+
+    bus->active = x;
+    x->status = I2C_XFER_ACTIVE;
+    bus->tx_pos = 0;
+    bus->rx_pos = 0;
+    bus->start_ms = tick_ms;
+    bus->timeout_ms = I2C_BUS_TIMEOUT_MS + (x->hdr_len + x->tx_len + x->rx_len) / 32;
+
+    // 等待上一次传输的STOP发完，再清掉它残留的中断标志
+    while (!(DL_I2C_getControllerStatus(inst) & DL_I2C_CONTROLLER_STATUS_IDLE) &&
+           ++spin < I2C_BUS_IDLE_SPIN);
+    DL_I2C_flushControllerTXFIFO(inst);
+    DL_I2C_flushControllerRXFIFO(inst);
+    DL_I2C_clearInterruptStatus(inst, I2C_BUS_INTERRUPTS | DL_I2C_INTERRUPT_CONTROLLER_TXFIFO_TRIGGER);
+
+    if (x->hdr_len) {
+        DL_I2C_fillControllerTXFIFO(inst, x->hdr, x->hdr_len);
+    }
+
+    if (x->rx_len) {
+        // 写后读：FIFO中的传输头先发出，然后重复起始读数据
+        if (x->hdr_len) {
+            inst->MASTER.MCTR = I2C_MCTR_RD_ON_TXEMPTY_ENABLE;
+        }
+        DL_I2C_startControllerTransfer(inst, x->addr, DL_I2C_CONTROLLER_DIRECTION_RX, x->rx_len);
+        return;
+    }
+
+    if (x->tx_len) {
+        if (cfg->dma_chan >= 0) {
+            // DMA由TX FIFO阈值触发，逐字节搬运写数据
+            DL_DMA_setSrcAddr(DMA, cfg->dma_chan, (uint32_t)x->tx);
+            DL_DMA_setDestAddr(DMA, cfg->dma_chan, (uint32_t)&inst->MASTER.MTXDATA);
+            DL_DMA_setTransferSize(DMA, cfg->dma_chan, x->tx_len);
+            DL_DMA_enableChannel(DMA, cfg->dma_chan);
+            bus->tx_pos = x->tx_len;
+        } else {
+            bus->tx_pos = DL_I2C_fillControllerTXFIFO(inst, x->tx, x->tx_len);
+            if (bus->tx_pos < x->tx_len) {
+                DL_I2C_enableInterrupt(inst, DL_I2C_INTERRUPT_CONTROLLER_TXFIFO_TRIGGER);
+            }
+        }
+    }
+    DL_I2C_startControllerTransfer(inst, x->addr, DL_I2C_CONTROLLER_DIRECTION_TX, x->hdr_len + x->tx_len);
+}
+
+/**
+ * @brief 结束当前传输：出队、设置状态、调用回调
+ * @note 先出队再设置状态，等待者看到完成后可以立即复用xfer；回调中可以再次提交
+ */
+static void I2C_Bus_Complete(I2C_Bus_t *bus, I2C_Xfer_Status_t status)
+{
+    const I2C_Bus_Config_t *cfg = bus->cfg;
+    I2C_Xfer_t *x = bus->active;
+
+    if (x == NULL) {
+        return;
+    }
+
+    if (cfg->dma_chan >= 0) {
+        DL_DMA_disableChannel(DMA, cfg->dma_chan);
+    }
+    DL_I2C_disableInterrupt(cfg->inst, DL_I2C_INTERRUPT_CONTROLLER_TXFIFO_TRIGGER);
+    cfg->inst->MASTER.MCTR = 0;
+    DL_I2C_flushControllerTXFIFO(cfg->inst);
+
+    bus->head = x->next;
+    if (bus->head == NULL) {
+        bus->tail = NULL;
+    }
+    x->next = NULL;
+    bus->active = NULL;
+    x->status = status;
+
+    if (x->done) {
+        x->done(x);
+    }
+}
+
+static void I2C_Bus_Finish(I2C_Bus_t *bus, I2C_Xfer_Status_t status)
+{
+    I2C_Bus_Complete(bus, status);
+    if (bus->active == NULL) {
+        I2C_Bus_Start(bus);
+    }
+}
+
+static void I2C_Bus_DrainRX(I2C_Bus_t *bus)
+{
+    I2C_Regs *inst = bus->cfg->inst;
+    I2C_Xfer_t *x = bus->active;
+
+    while (!DL_I2C_isControllerRXFIFOEmpty(inst)) {
+        uint8_t c = DL_I2C_receiveControllerData(inst);
+        if (x && bus->rx_pos < x->rx_len) {
+            x->rx[bus->rx_pos++] = c;
+        }
+    }
+}
+
+/**
+ * @brief 打开I2C外设对应的总线（多次调用返回同一个对象，同一外设上的客户端共用）
+ * @param cfg 客户端配置，第一个打开该外设的配置用于SDA解锁和恢复
+ * @return 总线对象
+ */
+I2C_Bus_t *I2C_Bus_Open(const I2C_Bus_Config_t *cfg)
+{
+    I2C_Bus_t *bus = &g_i2cBus[I2C_BUS_INDEX(cfg->inst)];
+
+    if (bus->cfg != NULL) {
+        return bus;
+    }
+
+    bus->cfg = cfg;
+    bus->head = NULL;
+    bus->tail = NULL;
+    bus->active = NULL;
+
+    if (DL_I2C_getSDAStatus(cfg->inst) == DL_I2C_CONTROLLER_SDA_LOW) {
+        I2C_Bus_SdaUnlock(cfg);
+    }
+    I2C_Bus_SetupInterrupts(cfg);
+    return bus;
+}
+
+/**
+ * @brief 提交一次传输，立即返回
+ * @param bus 总线
+ * @param xfer 传输描述，完成前调用者不能修改或释放
+ * @return true表示已排队，false表示参数非法或xfer尚未完成
+ * @note 可以在主循环、定时器中断和完成回调中调用
+ */
+bool I2C_Bus_Submit(I2C_Bus_t *bus, I2C_Xfer_t *xfer)
+{
+    uint32_t primask;
+
+    if (bus == NULL || bus->cfg == NULL || xfer == NULL) {
+        return false;
+    }
+    if (xfer->hdr_len > I2C_XFER_HDR_MAX ||
+        (xfer->rx_len && xfer->tx_len) ||
+        (xfer->hdr_len + xfer->tx_len + xfer->rx_len) == 0) {
+        return false;
+    }
+    if (xfer->status == I2C_XFER_PENDING || xfer->status == I2C_XFER_ACTIVE) {
+        return false;
+    }
+
+    xfer->next = NULL;
+    xfer->status = I2C_XFER_PENDING;
+
+    primask = I2C_Bus_Lock();
+    if (bus->tail) {
+        bus->tail->next = xfer;
+    } else {
+        bus->head = xfer;
+    }
+    bus->tail = xfer;
+    if (bus->active == NULL) {
+        I2C_Bus_Start(bus);
+    }
+    I2C_Bus_Unlock(primask);
+    return true;
+}
+
+/**
+ * @brief 等待传输完成（期间检查超时）
+ * @return 0表示成功，-1表示失败或超时
+ * @note 不能在优先级不低于I2C中断的上下文中调用
+ */
+int I2C_Bus_Wait(I2C_Bus_t *bus, I2C_Xfer_t *xfer)
+{
+    while (xfer->status == I2C_XFER_PENDING || xfer->status == I2C_XFER_ACTIVE) {
+        I2C_Bus_CheckTimeout(bus);
+    }
+    return xfer->status == I2C_XFER_DONE ? 0 : -1;
+}
+
+/**
+ * @brief 中止当前传输并复位外设，不解锁SDA（不延时，中断中也可以调用）
+ * @note SDA解锁记为待处理，由主循环中的I2C_Bus_CheckTimeout完成
+ */
+static void I2C_Bus_Abort(I2C_Bus_t *bus)
+{
+    const I2C_Bus_Config_t *cfg = bus->cfg;
+    uint8_t index = I2C_BUS_INDEX(cfg->inst);
+    uint32_t primask;
+
+    // 主循环正在解锁这条总线，由它结束当前传输
+    if (g_i2cRecovering[index]) {
+        return;
+    }
+
+    primask = I2C_Bus_Lock();
+    g_i2cUnlockPending[index] = true;
+    I2C_Bus_Enable(cfg);
+    I2C_Bus_SetupInterrupts(cfg);
+    I2C_Bus_Complete(bus, I2C_XFER_TIMEOUT);
+    if (bus->active == NULL) {
+        I2C_Bus_Start(bus);
+    }
+    I2C_Bus_Unlock(primask);
+}
+
+/**
+ * @brief 当前传输超时则中止并恢复总线
+ * @note 阻塞接口在等待时自动调用；只用异步接口的客户端应在主循环中定期调用。
+ *       在中断中调用时只中止传输并复位外设（I2C_Bus_Abort），需要延时的SDA解锁
+ *       推迟到下一次在主循环中调用时（总线空闲或再次超时）完成
+ */
+void I2C_Bus_CheckTimeout(I2C_Bus_t *bus)
+{
+    uint32_t primask;
+    bool expired;
+    bool in_isr = __get_IPSR() != 0;
+
+    if (bus->cfg == NULL) {
+        return;
+    }
+
+    primask = I2C_Bus_Lock();
+    expired = bus->active != NULL &&
+              (uint32_t)(tick_ms - bus->start_ms) > bus->timeout_ms;
+    I2C_Bus_Unlock(primask);
+
+    if (in_isr) {
+        if (expired) {
+            I2C_Bus_Abort(bus);
+        }
+    } else if (expired ||
+               (g_i2cUnlockPending[I2C_BUS_INDEX(bus->cfg->inst)] && bus->active == NULL)) {
+        I2C_Bus_Recover(bus);
+    }
+}
+
+/**
+ * @brief 中止当前传输，解锁SDA并重新初始化外设，然后继续处理队列
+ * @note 内部使用mspm0_delay_ms（最长约200ms），只能在主循环中调用；
+ *       在中断中调用时退化为I2C_Bus_Abort，解锁推迟到主循环
+ */
+void I2C_Bus_Recover(I2C_Bus_t *bus)
+{
+    const I2C_Bus_Config_t *cfg = bus->cfg;
+    uint8_t index;
+    uint32_t primask;
+
+    if (cfg == NULL) {
+        return;
+    }
+    if (__get_IPSR() != 0) {
+        I2C_Bus_Abort(bus);
+        return;
+    }
+    index = I2C_BUS_INDEX(cfg->inst);
+
+    // 恢复期间不启动新传输，提交的请求只排队
+    NVIC_DisableIRQ(cfg->irqn);
+    g_i2cRecovering[index] = true;
+    g_i2cUnlockPending[index] = false;
+
+    I2C_Bus_SdaUnlock(cfg);
+    I2C_Bus_SetupInterrupts(cfg);
+
+    primask = I2C_Bus_Lock();
+    g_i2cRecovering[index] = false;
+    I2C_Bus_Complete(bus, I2C_XFER_TIMEOUT);
+    if (bus->active == NULL) {
+        I2C_Bus_Start(bus);
+    }
+    I2C_Bus_Unlock(primask);
+}
+
+/**
+ * @brief I2C中断处理（由interrupt.c中的I2C0/I2C1中断入口调用）
+ */
+void I2C_Bus_IRQHandler(I2C_Regs *inst)
+{
+    I2C_Bus_t *bus = &g_i2cBus[I2C_BUS_INDEX(inst)];
+    I2C_Xfer_t *x = bus->active;
+
+    switch (DL_I2C_getPendingInterrupt(inst)) {
+        case DL_I2C_IIDX_CONTROLLER_TXFIFO_TRIGGER:
+            // FIFO快空了，继续补发写数据
+            if (x && bus->tx_pos < x->tx_len) {
+                bus->tx_pos += DL_I2C_fillControllerTXFIFO(inst, &x->tx[bus->tx_pos],
+                                                           x->tx_len - bus->tx_pos);
+            }
+            if (x == NULL || bus->tx_pos >= x->tx_len) {
+                DL_I2C_disableInterrupt(inst, DL_I2C_INTERRUPT_CONTROLLER_TXFIFO_TRIGGER);
+            }
+            break;
+
+        case DL_I2C_IIDX_CONTROLLER_RXFIFO_TRIGGER:
+            I2C_Bus_DrainRX(bus);
+            break;
+
+        case DL_I2C_IIDX_CONTROLLER_TX_DONE:
+            // 写后读的写阶段也会产生TX_DONE，只结束纯写传输
+            if (x && x->rx_len == 0) {
+                I2C_Bus_Finish(bus, I2C_XFER_DONE);
+            }
+            break;
+
+        case DL_I2C_IIDX_CONTROLLER_RX_DONE:
+            I2C_Bus_DrainRX(bus);
+            if (x) {
+                I2C_Bus_Finish(bus, bus->rx_pos == x->rx_len ? I2C_XFER_DONE : I2C_XFER_ERROR);
+            }
+            break;
+
+        case DL_I2C_IIDX_CONTROLLER_NACK:
+        case DL_I2C_IIDX_CONTROLLER_ARBITRATION_LOST:
+            if (x) {
+                I2C_Bus_Finish(bus, I2C_XFER_ERROR);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 阻塞传输：提交并等待完成
+ */
+static int I2C_Bus_Transfer(I2C_Bus_t *bus, I2C_Xfer_t *xfer)
+{
+    xfer->done = NULL;
+    xfer->arg = NULL;
+    xfer->status = I2C_XFER_IDLE;
+    if (!I2C_Bus_Submit(bus, xfer)) {
+        return -1;
+    }
+    return I2C_Bus_Wait(bus, xfer);
+}
+
+/**
+ * @brief 阻塞写：hdr和data在一次传输中连续发出
+ * @return 0表示成功，-1表示失败
+ */
+int I2C_Bus_Write(I2C_Bus_t *bus, uint8_t addr, const uint8_t *hdr, uint8_t hdr_len,
+                  const uint8_t *data, uint16_t len)
+{
+    I2C_Xfer_t xfer;
+
+    if (hdr_len > I2C_XFER_HDR_MAX) {
+        return -1;
+    }
+    xfer.addr = addr;
+    xfer.hdr_len = hdr_len;
+    if (hdr_len) {
+        memcpy(xfer.hdr, hdr, hdr_len);
+    }
+    xfer.tx = data;
+    xfer.tx_len = len;
+    xfer.rx = NULL;
+    xfer.rx_len = 0;
+    return I2C_Bus_Transfer(bus, &xfer);
+}
+
+/**
+ * @brief 阻塞读
+ * @return 0表示成功，-1表示失败
+ */
+int I2C_Bus_Read(I2C_Bus_t *bus, uint8_t addr, uint8_t *data, uint16_t len)
+{
+    I2C_Xfer_t xfer;
+
+    xfer.addr = addr;
+    xfer.hdr_len = 0;
+    xfer.tx = NULL;
+    xfer.tx_len = 0;
+    xfer.rx = data;
+    xfer.rx_len = len;
+    return I2C_Bus_Transfer(bus, &xfer);
+}
+
+/**
+ * @brief 阻塞写后读：发送tx后重复起始读rx_len字节
+ * @param tx_len 写阶段长度（<= I2C_XFER_HDR_MAX）
+ * @return 0表示成功，-1表示失败
+ */
+int I2C_Bus_WriteRead(I2C_Bus_t *bus, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                      uint8_t *rx, uint16_t rx_len)
+{
+    I2C_Xfer_t xfer;
+
+    if (tx_len > I2C_XFER_HDR_MAX) {
+        return -1;
+    }
+    xfer.addr = addr;
+    xfer.hdr_len = tx_len;
+    memcpy(xfer.hdr, tx, tx_len);
+    xfer.tx = NULL;
+    xfer.tx_len = 0;
+    xfer.rx = rx;
+    xfer.rx_len = rx_len;
+    return I2C_Bus_Transfer(bus, &xfer);
+}
+
+/**
+ * @brief 阻塞写寄存器：寄存器地址后连续写len字节
+ */
+int I2C_Bus_WriteReg(I2C_Bus_t *bus, uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len)
+{
+    return I2C_Bus_Write(bus, addr, &reg, 1, data, len);
+}
+
+/**
+ * @brief 阻塞读寄存器：从寄存器地址开始连续读len字节
+ */
+int I2C_Bus_ReadReg(I2C_Bus_t *bus, uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len)
+{
+    return I2C_Bus_WriteRead(bus, addr, &reg, 1, data, len);
+}
@@ -0,0 +1,135 @@
+/*
+ * i2c_bus.h
+ *
+ *  共享I2C传输引擎 - 中断/DMA驱动的排队传输
+ *
+ *  每个I2C外设（I2C0/I2C1）一个总线对象，挂在同一外设上的传感器共用一个队列，
+ *  两条总线各自独立、可以同时传输。传输由中断推进（FIFO阈值中断补发/收取数据，
+ *  TX_DONE/RX_DONE/NACK结束），CPU不再轮询DL_I2C_getControllerStatus。
+ *
+ *  用法：
+ *  - 客户端（传感器驱动）用SysConfig中的I2C模块名定义配置并打开总线：
+ *        static const I2C_Bus_Config_t cfg = I2C_BUS_CONFIG(MPU6050);
+ *        I2C_Bus_t *bus = I2C_Bus_Open(&cfg);
+ *  - 阻塞接口：I2C_Bus_WriteReg / I2C_Bus_ReadReg / I2C_Bus_Write / I2C_Bus_Read / I2C_Bus_WriteRead，
+ *    返回0成功，-1失败（NACK、仲裁丢失或超时，超时会自动解锁SDA并重新初始化外设）
+ *  - 异步接口：填好I2C_Xfer_t后I2C_Bus_Submit，完成时在中断中调用done回调
+ *
+ *  注意：I2C中断的优先级必须高于调用阻塞接口的上下文（定时器中断为1，I2C保持默认的0），
+ *  否则等待中的传输无法推进。
+ *
+ * SysConfig Configuration Steps (每个客户端的I2C模块):
+ *   I2C:
+ *     1. Add an I2C module and name it after the client (e.g. "I2C_MPU6050").
+ *     2. Check the box "Enable Controller Mode".
+ *     3. Set the pins according to your needs.
+ *     4. In "Interrupt Configuration", leave the interrupts unchecked
+ *        (the engine enables the ones it needs).
+ *   DMA (optional, offloads long writes such as OLED pages):
+ *     1. Set "Configure DMA TX Trigger" to "Controller TX FIFO trigger".
+ *     2. Use I2C_BUS_CONFIG_DMA(NAME, DMA_CHANNEL_NAME) instead of I2C_BUS_CONFIG.
+ */
+
+#ifndef _I2C_BUS_H_
+#define _I2C_BUS_H_
+
+#include "ti_msp_dl_config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_BUS_COUNT       2       // I2C0、I2C1
+#define I2C_XFER_HDR_MAX    8       // 传输头最大长度（写后读时整个写阶段必须放进TX FIFO）
+#define I2C_BUS_TIMEOUT_MS  10      // 单次传输超时基数（另外每32字节加1ms）
+
+// 传输状态
+typedef enum {
+    I2C_XFER_IDLE = 0,              // 未提交
+    I2C_XFER_PENDING,               // 排队中
+    I2C_XFER_ACTIVE,                // 正在传输
+    I2C_XFER_DONE,                  // 成功完成
+    I2C_XFER_ERROR,                 // NACK或仲裁丢失
+    I2C_XFER_TIMEOUT                // 超时被中止
+} I2C_Xfer_Status_t;
+
+// 一次传输（由调用者分配，完成前不能释放或修改）
+// - 写：      hdr + tx 在一次传输中连续发出（hdr通常是寄存器地址或控制字节）
+// - 读：      hdr_len = 0, rx_len > 0
+// - 写后读：  先发hdr，重复起始后读rx_len字节（tx_len必须为0）
+typedef struct I2C_Xfer {
+    uint8_t addr;                           // 7位从机地址
+    uint8_t hdr_len;                        // 传输头长度（<= I2C_XFER_HDR_MAX）
+    uint8_t hdr[I2C_XFER_HDR_MAX];          // 传输头，提交时直接装入TX FIFO
+    const uint8_t *tx;                      // 写数据
+    uint16_t tx_len;
+    uint8_t *rx;                            // 读缓冲区
+    uint16_t rx_len;
+    void (*done)(struct I2C_Xfer *xfer);    // 完成回调（在I2C中断中调用，可为NULL）
+    void *arg;                              // 回调自定义参数
+    volatile I2C_Xfer_Status_t status;      // 传输状态
+    struct I2C_Xfer *next;                  // 队列链表（引擎内部使用）
+} I2C_Xfer_t;
+
+// 总线配置（由I2C_BUS_CONFIG从SysConfig生成的名字展开）
+typedef struct {
+    I2C_Regs *inst;                         // I2C外设
+    IRQn_Type irqn;                         // 中断号
+    uint32_t scl_iomux;                     // SCL/SDA引脚（解锁SDA时切换为GPIO）
+    uint32_t scl_iomux_func;
+    uint32_t sda_iomux;
+    uint32_t sda_iomux_func;
+    GPIO_Regs *scl_port;
+    uint32_t scl_pin;
+    GPIO_Regs *sda_port;
+    uint32_t sda_pin;
+    void (*init)(void);                     // SysConfig生成的外设初始化函数
+    int8_t dma_chan;                        // 写数据使用的DMA通道，-1表示不用DMA
+} I2C_Bus_Config_t;
+
+#define I2C_BUS_CONFIG_DMA(NAME, DMA_NAME) {                    \
+    .inst           = I2C_##NAME##_INST,                        \
+    .irqn           = I2C_##NAME##_INST_INT_IRQN,               \
+    .scl_iomux      = GPIO_I2C_##NAME##_IOMUX_SCL,              \
+    .scl_iomux_func = GPIO_I2C_##NAME##_IOMUX_SCL_FUNC,         \
+    .sda_iomux      = GPIO_I2C_##NAME##_IOMUX_SDA,              \
+    .sda_iomux_func = GPIO_I2C_##NAME##_IOMUX_SDA_FUNC,         \
+    .scl_port       = GPIO_I2C_##NAME##_SCL_PORT,               \
+    .scl_pin        = GPIO_I2C_##NAME##_SCL_PIN,                \
+    .sda_port       = GPIO_I2C_##NAME##_SDA_PORT,               \
+    .sda_pin        = GPIO_I2C_##NAME##_SDA_PIN,                \
+    .init           = SYSCFG_DL_I2C_##NAME##_init,              \
+    .dma_chan       = DMA_NAME##_CHAN_ID                        \
+}
+
+#define I2C_BUS_NO_DMA_CHAN_ID  (-1)
+#define I2C_BUS_CONFIG(NAME)    I2C_BUS_CONFIG_DMA(NAME, I2C_BUS_NO_DMA)
+
+// 总线对象
+typedef struct {
+    const I2C_Bus_Config_t *cfg;            // 第一个打开该外设的客户端配置
+    I2C_Xfer_t *head;                       // 队列头（正在传输或下一个要传输的）
+    I2C_Xfer_t *tail;                       // 队列尾
+    I2C_Xfer_t *volatile active;            // 正在传输的项，空闲时为NULL
+    uint16_t tx_pos;                        // 已装入FIFO的tx字节数
+    uint16_t rx_pos;                        // 已收到的rx字节数
+    uint32_t start_ms;                      // 当前传输开始时间
+    uint32_t timeout_ms;                    // 当前传输超时时间
+} I2C_Bus_t;
+
+// 函数声明
+I2C_Bus_t *I2C_Bus_Open(const I2C_Bus_Config_t *cfg);
+bool I2C_Bus_Submit(I2C_Bus_t *bus, I2C_Xfer_t *xfer);
+int I2C_Bus_Wait(I2C_Bus_t *bus, I2C_Xfer_t *xfer);
+void I2C_Bus_CheckTimeout(I2C_Bus_t *bus);
+void I2C_Bus_Recover(I2C_Bus_t *bus);
+void I2C_Bus_IRQHandler(I2C_Regs *inst);
+
+int I2C_Bus_Write(I2C_Bus_t *bus, uint8_t addr, const uint8_t *hdr, uint8_t hdr_len,
+                  const uint8_t *data, uint16_t len);
+int I2C_Bus_Read(I2C_Bus_t *bus, uint8_t addr, uint8_t *data, uint16_t len);
+int I2C_Bus_WriteRead(I2C_Bus_t *bus, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                      uint8_t *rx, uint16_t rx_len);
+int I2C_Bus_WriteReg(I2C_Bus_t *bus, uint8_t addr, uint8_t reg, const uint8_t *data, uint16_t len);
+int I2C_Bus_ReadReg(I2C_Bus_t *bus, uint8_t addr, uint8_t reg, uint8_t *data, uint16_t len);
+
+#endif  /* #ifndef _I2C_BUS_H_ */
@@ -9,6 +9,9 @@
 #include "motor_control.h"
 #include "turn_detection.h"
 #include "Encoder.h"
+#include "oled.h"
+#include "i2c_bus.h"
+#include "heading.h"
 
 // 函数声明
 void Encoder_IRQHandler(void);
@@ -119,17 +122,42 @@ void UART_WIT_INST_IRQHandler(void)
 }
 #endif
 
+/* I2C传输引擎：两条总线的中断都交给i2c_bus.c推进（传感器读写、OLED异步刷新） */
+void I2C0_IRQHandler(void)
+{
+    I2C_Bus_IRQHandler(I2C0);
+}
+
+void I2C1_IRQHandler(void)
+{
+    I2C_Bus_IRQHandler(I2C1);
+}
+
+/* OLED异步刷新：一页发送完成后推进到下一页 */
+#if OLED_TRANSPORT_ASYNC && OLED_TRANSPORT == OLED_TRANSPORT_HW_SPI && defined SPI_OLED_INST_IRQHandler
+void SPI_OLED_INST_IRQHandler(void)
+{
+    switch (DL_SPI_getPendingInterrupt(SPI_OLED_INST)) {
+        case DL_SPI_IIDX_IDLE:
+            OLED_TxDone_IRQHandler();
+            break;
+        default:
+            break;
+    }
+}
+#endif
+
 void GROUP1_IRQHandler(void)
 {
     switch (DL_Interrupt_getPendingGroup(DL_INTERRUPT_GROUP_1)) {
         /* GPIOB 多功能中断处理 - MPU6050 和 编码器都在这里 */
         #if defined GPIO_MULTIPLE_GPIOB_INT_IIDX
         case GPIO_MULTIPLE_GPIOB_INT_IIDX:
-            // 检查是否是MPU6050中断
+            // 检查是否是MPU6050中断（只锁存，FIFO由I2C中断异步读取，不阻塞编码器）
             #if defined GPIO_MPU6050_PORT && defined GPIO_MPU6050_PIN_INT_PIN
             if (DL_GPIO_getEnabledInterruptStatus(GPIO_MPU6050_PORT, GPIO_MPU6050_PIN_INT_PIN)) {
-                Read_Quad();
                 DL_GPIO_clearInterruptStatus(GPIO_MPU6050_PORT, GPIO_MPU6050_PIN_INT_PIN);
+                MPU6050_IRQHandler();
             }
             #endif
             
@@ -184,6 +212,14 @@ void TIMA1_IRQHandler(void)
     
     // 先处理编码器速度计算
     Encoder_Timer_IRQHandler();
+
+    // 解码MPU6050最新的FIFO数据包（下半部，不访问总线；超时恢复和FIFO复位在主循环的MPU6050_Service中），
+    // 展开成连续航向供偏航PID使用
+    #if defined GPIO_MPU6050_PORT && defined GPIO_MPU6050_PIN_INT_PIN
+    if (Read_Quad() == 0) {
+        Heading_Update(yaw);
+    }
+    #endif
     
     // 然后更新PID控制
     MotorControl_Update();
@@ -0,0 +1,56 @@
+/*
+ * seqlock.h
+ *
+ *  顺序锁（sequence counter）- 中断与主循环之间无锁共享多字段数据
+ *
+ *  用法：
+ *  - 写者（只能有一个优先级的中断写）：
+ *        seqlock_write_begin(&lock); 更新数据; seqlock_write_end(&lock);
+ *  - 读者（主循环或不高于写者优先级的中断）：
+ *        do { seq = seqlock_read_begin(&lock); 拷贝数据; } while (seqlock_read_retry(&lock, seq));
+ *
+ *  写期间序号为奇数，读者拷贝前后序号不一致就重读，因此总能拿到一份完整一致的数据，
+ *  全程不需要关中断。注意：优先级高于写者的中断不能作为读者（写者被抢占时会一直重读）。
+ */
+
+#ifndef _SEQLOCK_H_
+#define _SEQLOCK_H_
+
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t seq;
+} seqlock_t;
+
+// 单核M0+只需阻止编译器重排访存
+#define SEQLOCK_BARRIER() __asm volatile ("" ::: "memory")
+
+static inline void seqlock_write_begin(seqlock_t *lock)
+{
+    lock->seq++;
+    SEQLOCK_BARRIER();
+}
+
+static inline void seqlock_write_end(seqlock_t *lock)
+{
+    SEQLOCK_BARRIER();
+    lock->seq++;
+}
+
+static inline uint32_t seqlock_read_begin(const seqlock_t *lock)
+{
+    uint32_t seq;
+    do {
+        seq = lock->seq;
+    } while (seq & 1u);
+    SEQLOCK_BARRIER();
+    return seq;
+}
+
+static inline int seqlock_read_retry(const seqlock_t *lock, uint32_t seq)
+{
+    SEQLOCK_BARRIER();
+    return lock->seq != seq;
+}
+
+#endif  /* #ifndef _SEQLOCK_H_ */
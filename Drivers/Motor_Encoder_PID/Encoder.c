@@ -1,13 +1,65 @@
 #include "Encoder.h"
+#include "clock.h"
+#include "seqlock.h"
+#include "fast_math.h"
 
 // 内部变量 - 双电机
 static volatile int32_t encoder_count[2] = {0, 0};      // 编码器计数 [左电机, 右电机]
 static volatile int32_t last_count[2] = {0, 0};         // 上次计数值
 static volatile int32_t motor_speed_pps[2] = {0, 0};    // 当前速度（每秒脉冲数 PPS）
 static volatile float motor_speed_rps[2] = {0.0f, 0.0f};    // 当前速度（每秒转速 RPS）
+static volatile uint32_t encoder_error[2] = {0, 0};     // 非法跳变计数（丢失的边沿）
+static uint8_t encoder_state[2] = {0, 0};               // 上次A/B相电平 (A<<1 | B)
+
+// M/T法测速：边沿中断记录最近一次有效边沿的时间戳，10ms快照时用“脉冲数/边沿间隔”计算速度
+static volatile uint32_t edge_time[2] = {0, 0};         // 最近一次有效边沿时间戳（CPU周期）
+static int32_t mt_last_count[2] = {0, 0};               // 上次参与计算的边沿对应的计数值
+static uint32_t mt_last_time[2] = {0, 0};               // 上次参与计算的边沿时间戳
+static volatile float motor_speed_precise[2] = {0.0f, 0.0f}; // M/T法速度（PPS）
+
+// 速度快照（10ms定时器中断为唯一写者）
+static Encoder_Snapshot_t encoder_snapshot;
+static seqlock_t encoder_snapshot_lock;
+
+#define MT_TIMEOUT_CYCLES ((uint32_t)ENCODER_MT_TIMEOUT_MS * (CPUCLK_FREQ / 1000))
+#define RPS_PER_PPS (1.0f / PULSES_PER_REVOLUTION)      // PPS换算为RPS的系数（乘法代替除法）
+
+// 非法跳变标记：A/B两相同时变化，无法判断方向
+#define ENC_ILL 2
+
+/*
+ * 正交解码查找表，索引 = (上次状态 << 2) | 当前状态，状态 = (A << 1) | B
+ * 与原逻辑一致：A相跳变后 A!=B 记+1，B相跳变后 A!=B 记-1
+ * 表对A/B同时取反对称，因此直接使用引脚原始电平（Read_Encoder_xx宏的取反无需处理）
+ */
+static const int8_t quad_table[16] = {
+/* 新状态:  00       01       10       11   */
+            0,      -1,      +1,      ENC_ILL,  /* 上次 00 */
+           +1,       0,      ENC_ILL, -1,       /* 上次 01 */
+           -1,      ENC_ILL,  0,      +1,       /* 上次 10 */
+           ENC_ILL, +1,      -1,       0        /* 上次 11 */
+};
+
+/**
+ * @brief 从一次端口读取结果中提取指定车轮的A/B相状态
+ */
+#define ENC_STATE_L(port) ((uint8_t)((((port) & GPIO_ENCODER_PIN_A1_PIN) ? 2 : 0) | (((port) & GPIO_ENCODER_PIN_A2_PIN) ? 1 : 0)))
+#define ENC_STATE_R(port) ((uint8_t)((((port) & GPIO_ENCODER_PIN_B1_PIN) ? 2 : 0) | (((port) & GPIO_ENCODER_PIN_B2_PIN) ? 1 : 0)))
 
 
 
+/**
+ * @brief 重置单个车轮的M/T测速状态
+ */
+static void Encoder_MT_Reset(uint8_t motor_id)
+{
+    uint32_t now = mspm0_get_clock_cycles();
+    edge_time[motor_id] = now;
+    mt_last_time[motor_id] = now;
+    mt_last_count[motor_id] = encoder_count[motor_id];
+    motor_speed_precise[motor_id] = 0.0f;
+}
+
 /**
  * @brief 初始化编码器
  */
@@ -22,11 +74,18 @@ void Encoder_Init(void)
     motor_speed_pps[1] = 0;
     motor_speed_rps[0] = 0.0f;
     motor_speed_rps[1] = 0.0f;
+    encoder_error[0] = 0;
+    encoder_error[1] = 0;
+    Encoder_MT_Reset(0);
+    Encoder_MT_Reset(1);
+
+    // 记录初始A/B相电平，作为查表解码的起点
+    uint32_t port = DL_GPIO_readPins(GPIO_ENCODER_PORT, ENCODER_PINS_ALL);
+    encoder_state[0] = ENC_STATE_L(port);
+    encoder_state[1] = ENC_STATE_R(port);
     
     // 清除中断状态
-    DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, 
-    GPIO_ENCODER_PIN_A1_PIN | GPIO_ENCODER_PIN_A2_PIN |
-    GPIO_ENCODER_PIN_B1_PIN | GPIO_ENCODER_PIN_B2_PIN);
+    DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, ENCODER_PINS_ALL);
 
     // 使能NVIC中断
     NVIC_EnableIRQ(GPIOB_INT_IRQn);
@@ -106,45 +165,95 @@ void Encoder_Reset(uint8_t motor_id)
         motor_speed_pps[1] = 0;
         motor_speed_rps[0] = 0.0f;
         motor_speed_rps[1] = 0.0f;
+        encoder_error[0] = 0;
+        encoder_error[1] = 0;
+        Encoder_MT_Reset(0);
+        Encoder_MT_Reset(1);
     } else if (motor_id < 2) {
         encoder_count[motor_id] = 0;
         last_count[motor_id] = 0;
         motor_speed_pps[motor_id] = 0;
         motor_speed_rps[motor_id] = 0.0f;
+        encoder_error[motor_id] = 0;
+        Encoder_MT_Reset(motor_id);
     }
 }
 
+/**
+ * @brief 获取编码器非法跳变次数
+ * @param motor_id 电机ID (0=左电机, 1=右电机)
+ * @return 自上次重置以来A/B相同时变化的次数，非零说明中断响应不及时丢失了边沿
+ */
+uint32_t Encoder_GetErrorCount(uint8_t motor_id)
+{
+    if (motor_id >= 2) return 0;
+    return encoder_error[motor_id];
+}
+
+/**
+ * @brief 获取M/T法测得的编码器速度（带方向）
+ * @param motor_id 电机ID (0=左电机, 1=右电机)
+ * @return 每秒脉冲数（PPS，带小数），正负表示方向
+ * @note 10ms窗口内的脉冲数除以首尾边沿的实际时间间隔，低速时不再是100PPS的整数倍
+ */
+float Encoder_GetSpeed_Precise(uint8_t motor_id)
+{
+    if (motor_id >= 2) return 0.0f;
+    return motor_speed_precise[motor_id];
+}
+
+/**
+ * @brief 获取两轮编码器计数和速度的一致快照
+ * @param out 输出快照
+ * @note 无锁读取，可在主循环或优先级不高于TIMER_CALC的中断中调用
+ */
+void Encoder_GetSnapshot(Encoder_Snapshot_t *out)
+{
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&encoder_snapshot_lock);
+        *out = encoder_snapshot;
+    } while (seqlock_read_retry(&encoder_snapshot_lock, seq));
+}
+
 /**
  * @brief 编码器GPIO中断处理函数
+ * @note 每次中断只读取一次GPIO_ENCODER_PORT，两个车轮都用(上次状态, 当前状态)查表解码，
+ *       无论是哪个引脚触发都重新采样，因此一次中断可以同时处理多个边沿
  */
 void Encoder_IRQHandler(void)
 {
     if(DL_Interrupt_getStatusGroup(DL_INTERRUPT_GROUP_1,DL_INTERRUPT_GROUP1_GPIOB)){
         // 检查是否是编码器引脚的中断
-        uint32_t gpioB = DL_GPIO_getEnabledInterruptStatus(GPIO_ENCODER_PORT,
-            GPIO_ENCODER_PIN_A1_PIN | GPIO_ENCODER_PIN_A2_PIN | 
-            GPIO_ENCODER_PIN_B1_PIN | GPIO_ENCODER_PIN_B2_PIN);
-        
-        // 左电机编码器A1
-        if ((gpioB & GPIO_ENCODER_PIN_A1_PIN) == GPIO_ENCODER_PIN_A1_PIN) {
-            DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, GPIO_ENCODER_PIN_A1_PIN);
-            encoder_count[0] += (Read_Encoder_A1^Read_Encoder_A2) ? 1 : -1;
-        }
-        // 左电机编码器A2
-        if ((gpioB & GPIO_ENCODER_PIN_A2_PIN) == GPIO_ENCODER_PIN_A2_PIN) {
-            DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, GPIO_ENCODER_PIN_A2_PIN);
-            encoder_count[0] += (Read_Encoder_A1^Read_Encoder_A2) ? -1 : 1;
-        }
-        // 右电机编码器B1
-        if ((gpioB & GPIO_ENCODER_PIN_B1_PIN) == GPIO_ENCODER_PIN_B1_PIN) {
-            DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, GPIO_ENCODER_PIN_B1_PIN);
-            encoder_count[1] += (Read_Encoder_B1^Read_Encoder_B2) ? 1 : -1;
+        uint32_t gpioB = DL_GPIO_getEnabledInterruptStatus(GPIO_ENCODER_PORT, ENCODER_PINS_ALL);
+        if (gpioB == 0) return;
+
+        // 先清除中断再采样，保证采样之后的新边沿会再次触发中断
+        DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, gpioB);
+        uint32_t port = DL_GPIO_readPins(GPIO_ENCODER_PORT, ENCODER_PINS_ALL);
+        uint32_t now = mspm0_get_clock_cycles();
+
+        // 左电机
+        uint8_t state = ENC_STATE_L(port);
+        int8_t step = quad_table[(encoder_state[0] << 2) | state];
+        if (step == ENC_ILL) {
+            encoder_error[0]++;
+        } else {
+            encoder_count[0] += step;
+            if (step) edge_time[0] = now;
         }
-        // 右电机编码器B2
-        if ((gpioB & GPIO_ENCODER_PIN_B2_PIN) == GPIO_ENCODER_PIN_B2_PIN) {
-            DL_GPIO_clearInterruptStatus(GPIO_ENCODER_PORT, GPIO_ENCODER_PIN_B2_PIN);
-            encoder_count[1] += (Read_Encoder_B1^Read_Encoder_B2) ? -1 : 1;
+        encoder_state[0] = state;
+
+        // 右电机
+        state = ENC_STATE_R(port);
+        step = quad_table[(encoder_state[1] << 2) | state];
+        if (step == ENC_ILL) {
+            encoder_error[1]++;
+        } else {
+            encoder_count[1] += step;
+            if (step) edge_time[1] = now;
         }
+        encoder_state[1] = state;
     }
 }
 
@@ -163,11 +272,52 @@ void Encoder_Timer_IRQHandler(void)
 
         // 新增：计算每秒转数 (RPS)
         // RPS = PPS / 每转总脉冲数
-        motor_speed_rps[i] = (float)motor_speed_pps[i] / PULSES_PER_REVOLUTION;
+        motor_speed_rps[i] = (float)motor_speed_pps[i] * RPS_PER_PPS;
+
+        // M/T法：用窗口内最后一个边沿与上次参与计算的边沿之间的脉冲数和精确时间间隔计算速度
+        // 边沿中断与本中断同为优先级1，互不抢占，edge_time与encoder_count读取一致
+        int32_t edge_count = encoder_count[i];
+        uint32_t edge_t = edge_time[i];
+        int32_t mt_diff = edge_count - mt_last_count[i];
+        uint32_t mt_dt = edge_t - mt_last_time[i];
+
+        if (mt_diff != 0 && mt_dt > 0 && mt_dt < MT_TIMEOUT_CYCLES) {
+            motor_speed_precise[i] = FastMath_Div((float)mt_diff * (float)CPUCLK_FREQ, (float)mt_dt);
+        } else if (mt_diff != 0) {
+            // 从静止起步，上一个边沿太久远，退化为M法
+            motor_speed_precise[i] = (float)motor_speed_pps[i];
+        } else {
+            // 窗口内没有新边沿：速度上限为“1个脉冲/距上次边沿的时间”，超时则判为停止
+            uint32_t since = mspm0_get_clock_cycles() - mt_last_time[i];
+            if (since >= MT_TIMEOUT_CYCLES) {
+                motor_speed_precise[i] = 0.0f;
+            } else {
+                float bound = FastMath_Div((float)CPUCLK_FREQ, (float)since);
+                if (motor_speed_precise[i] > bound) {
+                    motor_speed_precise[i] = bound;
+                } else if (motor_speed_precise[i] < -bound) {
+                    motor_speed_precise[i] = -bound;
+                }
+            }
+        }
+        if (mt_diff != 0) {
+            mt_last_count[i] = edge_count;
+            mt_last_time[i] = edge_t;
+        }
         
         // 保存当前计数值供下次计算使用
         last_count[i] = encoder_count[i];
     }
+
+    // 整体发布速度快照
+    seqlock_write_begin(&encoder_snapshot_lock);
+    for (int i = 0; i < 2; i++) {
+        encoder_snapshot.count[i] = last_count[i];
+        encoder_snapshot.speed_pps[i] = motor_speed_pps[i];
+        encoder_snapshot.speed_precise[i] = motor_speed_precise[i];
+        encoder_snapshot.speed_precise_q16[i] = (int32_t)(motor_speed_precise[i] * 65536.0f);
+    }
+    seqlock_write_end(&encoder_snapshot_lock);
     
     // 注意：中断清除已移到TIMA1_IRQHandler中进行，确保中断能及时清除
     // DL_TimerA_clearInterruptStatus(TIMER_CALC_INST, DL_TIMER_INTERRUPT_ZERO_EVENT);
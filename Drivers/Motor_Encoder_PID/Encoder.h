@@ -22,6 +22,21 @@
 #define Read_Encoder_B1 (DL_GPIO_readPins(GPIO_ENCODER_PORT,GPIO_ENCODER_PIN_B1_PIN)==GPIO_ENCODER_PIN_B1_PIN)?0:1//右轮 A相
 #define Read_Encoder_B2 (DL_GPIO_readPins(GPIO_ENCODER_PORT,GPIO_ENCODER_PIN_B2_PIN)==GPIO_ENCODER_PIN_B2_PIN)?0:1//右轮 B相
 
+/*编码器引脚掩码（左轮A1/A2，右轮B1/B2），中断中整端口读取一次后按掩码拆分*/
+#define ENCODER_PINS_ALL (GPIO_ENCODER_PIN_A1_PIN | GPIO_ENCODER_PIN_A2_PIN | \
+                          GPIO_ENCODER_PIN_B1_PIN | GPIO_ENCODER_PIN_B2_PIN)
+
+
+// M/T法测速：无新边沿超过该时间认为已停止（毫秒）
+#define ENCODER_MT_TIMEOUT_MS 200
+
+// 编码器速度快照（由10ms定时器中断整体发布，保证多个字段来自同一时刻）
+typedef struct {
+    int32_t count[2];           // 快照时刻的编码器计数
+    int32_t speed_pps[2];       // 10ms脉冲计数速度（PPS）
+    float speed_precise[2];     // M/T法速度（PPS）
+    int32_t speed_precise_q16[2]; // M/T法速度（PPS，Q16.16定点，定点速度环直接使用）
+} Encoder_Snapshot_t;
 
 // 编码器相关函数
 void Encoder_Init(void);                           // 初始化编码器
@@ -31,6 +46,9 @@ uint32_t Encoder_GetSpeed_PPS_Abs(uint8_t motor_id);    // 获取编码器速度
 float Encoder_GetSpeed_RPS(uint8_t motor_id);    // 获取编码器速度(每秒转数 RPS)
 float Encoder_GetSpeed_RPS_Abs(uint8_t motor_id);   // 获取编码器速度绝对值(RPS)
 void Encoder_Reset(uint8_t motor_id);              // 重置编码器计数 (0=左电机, 1=右电机, 2=全部)
+uint32_t Encoder_GetErrorCount(uint8_t motor_id);  // 获取非法跳变次数（A/B相同时变化，说明丢边沿）
+float Encoder_GetSpeed_Precise(uint8_t motor_id);  // 获取M/T法速度(PPS，带小数，低速分辨率高)
+void Encoder_GetSnapshot(Encoder_Snapshot_t *out); // 获取两轮计数和速度的一致快照（无锁）
 void Encoder_IRQHandler(void);                     // 编码器中断处理函数
 
 // 定时器中断处理函数（用于速度计算）
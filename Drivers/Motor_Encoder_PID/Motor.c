@@ -6,6 +6,7 @@
 // =====================================================================================================================
 
 #define MIN_PWM_DUTY 0.1f   // 最小有效PWM占空比，防止电机在极低速度下不转或抖动
+#define MIN_PWM_DUTY_Q16 ((int32_t)(MIN_PWM_DUTY * 65536.0f))  // 最小有效PWM占空比（Q16）
 #define MOTOR_A      0      // 电机A的ID
 #define MOTOR_B      1      // 电机B的ID
 #define MOTOR_ALL    2      // 代表两个电机
@@ -24,6 +25,8 @@ static void Motor_PWM_Start(void);
 static void Motor_PWM_Stop(void);
 static void Motor_SetDirection(uint8_t motor_id, int8_t direction);
 static void Motor_SetPWM(uint8_t motor_id, float duty);
+static void Motor_SetPWM_Q16(uint8_t motor_id, uint32_t duty);
+static void Motor_Run_Q16(uint8_t motor_id, int32_t pwm);
 
 // =====================================================================================================================
 // 公共函数定义
@@ -184,6 +187,51 @@ static void Motor_SetPWM(uint8_t motor_id, float duty)
     }
 }
 
+/**
+ * @brief 设置单个电机的PWM占空比（Q16）
+ * @note  内部函数，与Motor_SetPWM相同，只用整数运算。
+ * @param motor_id 电机ID (MOTOR_A 或 MOTOR_B)
+ * @param duty     占空比 (0 到 1.0，Q16)
+ */
+static void Motor_SetPWM_Q16(uint8_t motor_id, uint32_t duty)
+{
+    if (duty > 65536u) duty = 65536u;
+
+    // 周期值为16位，period × duty 不超过32位
+    uint32_t period = DL_TimerA_getLoadValue(PWM_MOTOR_INST);
+    uint32_t pwm_value = period - ((period * duty) >> 16);
+
+    if (motor_id == MOTOR_A) {
+        DL_TimerA_setCaptureCompareValue(PWM_MOTOR_INST, pwm_value, DL_TIMER_CC_0_INDEX);
+    } else if (motor_id == MOTOR_B) {
+        DL_TimerA_setCaptureCompareValue(PWM_MOTOR_INST, pwm_value, DL_TIMER_CC_1_INDEX);
+    }
+}
+
+/**
+ * @brief 以指定PWM驱动电机（Q16）
+ * @note  内部函数，逻辑与Motor_Run相同（0停止、最小有效占空比）。
+ * @param motor_id 电机ID (MOTOR_A 或 MOTOR_B)
+ * @param pwm      PWM值 (-100.0 到 100.0，Q16)
+ */
+static void Motor_Run_Q16(uint8_t motor_id, int32_t pwm)
+{
+    uint32_t duty;
+
+    if (pwm == 0) {
+        Motor_Stop(motor_id);
+        return;
+    }
+
+    duty = (uint32_t)((pwm > 0) ? pwm : -pwm) / 100u;
+    if (duty < (uint32_t)MIN_PWM_DUTY_Q16) {
+        duty = MIN_PWM_DUTY_Q16;
+    }
+
+    Motor_SetDirection(motor_id, (pwm > 0) ? 1 : -1);
+    Motor_SetPWM_Q16(motor_id, duty);
+}
+
 /**
  * @brief 设置双电机PWM
  * 
@@ -200,3 +248,15 @@ void Motor_Set_Pwm(float pwm_L, float pwm_R)
     Motor_Run(MOTOR_A, speed_L);
     Motor_Run(MOTOR_B, speed_R);
 }
+
+/**
+ * @brief 设置双电机PWM（Q16.16定点）
+ * 
+ * @param pwm_L 左电机PWM值 (-100.0 到 100.0，Q16.16)
+ * @param pwm_R 右电机PWM值 (-100.0 到 100.0，Q16.16)
+ */
+void Motor_Set_Pwm_Q16(int32_t pwm_L, int32_t pwm_R)
+{
+    Motor_Run_Q16(MOTOR_A, pwm_L);
+    Motor_Run_Q16(MOTOR_B, pwm_R);
+}
@@ -33,6 +33,15 @@ void Motor_Stop(uint8_t motor_id);
  */
 void Motor_Set_Pwm(float pwm_L, float pwm_R);
 
+/**
+ * @brief 设置双电机PWM（Q16.16定点）
+ * 
+ * @param pwm_L 左电机PWM值 (-100.0 到 100.0，Q16.16)
+ * @param pwm_R 右电机PWM值 (-100.0 到 100.0，Q16.16)
+ * @note 全程整数运算，供定点速度环在控制中断中调用
+ */
+void Motor_Set_Pwm_Q16(int32_t pwm_L, int32_t pwm_R);
+
 // 电机ID定义
 #define MOTOR_A      0      // 电机A的ID
 #define MOTOR_B      1      // 电机B的ID
@@ -0,0 +1,96 @@
+/*
+ * heading.c
+ *
+ *  航向服务实现 - yaw展开与最短路径误差
+ */
+
+#include "heading.h"
+#include <math.h>
+
+Heading_t g_heading;
+
+/**
+ * @brief 清空航向状态，下一个yaw样本作为新的起点（圈数归零）
+ */
+void Heading_Reset(void)
+{
+    g_heading.valid = false;
+    g_heading.turns = 0;
+    g_heading.heading = 0.0f;
+    g_heading.last_yaw = 0.0f;
+}
+
+/**
+ * @brief 输入一个新的yaw样本，更新连续航向
+ * @param yaw_deg 姿态解算输出的yaw（度，范围±180）
+ * @note 相邻两个样本之间的真实转角必须小于180°（50Hz DMP输出下对应9000°/s，不会出现）
+ */
+void Heading_Update(float yaw_deg)
+{
+    if (!g_heading.valid) {
+        g_heading.turns = 0;
+        g_heading.last_yaw = yaw_deg;
+        g_heading.heading = yaw_deg;
+        g_heading.valid = true;
+        return;
+    }
+
+    float delta = yaw_deg - g_heading.last_yaw;
+    if (delta > 180.0f) {
+        // 从-180跳到+180：实际是顺时针越过边界
+        g_heading.turns--;
+    } else if (delta < -180.0f) {
+        // 从+180跳到-180：实际是逆时针越过边界
+        g_heading.turns++;
+    }
+    g_heading.last_yaw = yaw_deg;
+    g_heading.heading = (float)g_heading.turns * 360.0f + yaw_deg;
+}
+
+/**
+ * @brief 获取连续航向
+ * @return 航向（度），不回绕
+ */
+float Heading_Get(void)
+{
+    return g_heading.heading;
+}
+
+/**
+ * @brief 是否已有航向数据
+ */
+bool Heading_IsValid(void)
+{
+    return g_heading.valid;
+}
+
+/**
+ * @brief 把角度折叠到[-180, 180)
+ * @param angle 任意角度（度）
+ * @return 等价角度
+ */
+float Heading_Wrap180(float angle)
+{
+    // 正常输入只差一两圈，循环比fmodf（软件浮点除法）快；异常大的输入先取模
+    if (angle > 3600.0f || angle < -3600.0f) {
+        angle = fmodf(angle, 360.0f);
+    }
+    while (angle >= 180.0f) {
+        angle -= 360.0f;
+    }
+    while (angle < -180.0f) {
+        angle += 360.0f;
+    }
+    return angle;
+}
+
+/**
+ * @brief 航向误差（最短路径）
+ * @param target 目标航向（度，±180内或连续航向均可）
+ * @param current 当前航向（度，±180内或连续航向均可）
+ * @return target - current 折叠到[-180, 180)，正值表示需要逆时针（左）转
+ */
+float Heading_Error(float target, float current)
+{
+    return Heading_Wrap180(target - current);
+}
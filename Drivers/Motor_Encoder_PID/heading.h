@@ -0,0 +1,41 @@
+/*
+ * heading.h
+ *
+ *  航向服务 - 把陀螺仪输出的±180°yaw展开成连续航向
+ *
+ *  姿态解算给出的yaw在±180°处回绕，直接做差或送入PID会在边界处产生360°的跳变。
+ *  本模块在每个新的yaw样本到来时统计跨越边界的圈数，发布连续航向：
+ *      heading = turns * 360 + yaw
+ *  连续航向没有累积误差（圈数是整数），可以跨任意圈数直接相减计算已转过的角度。
+ *
+ *  用法：
+ *  - 姿态更新处调用Heading_Update(yaw)（默认在TIMA1中断中Read_Quad得到新数据后调用）
+ *  - 转弯：start = Heading_Get(); ... 转过的角度 = Heading_Get() - start
+ *  - 航向保持：误差 = Heading_Error(target, Heading_Get())，目标可以是±180°内的角度或连续航向，
+ *    误差总是取最短路径，范围[-180, 180)
+ */
+
+#ifndef HEADING_H_
+#define HEADING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 航向数据（TIMA1中断写，其他上下文只读）
+typedef struct {
+    volatile float heading;     // 连续航向（度）
+    volatile int32_t turns;     // 跨越±180°边界的圈数（逆时针为正）
+    float last_yaw;             // 上一个yaw样本（度）
+    volatile bool valid;        // 已收到第一个样本
+} Heading_t;
+
+extern Heading_t g_heading;
+
+void Heading_Reset(void);
+void Heading_Update(float yaw_deg);
+float Heading_Get(void);
+bool Heading_IsValid(void);
+float Heading_Wrap180(float angle);
+float Heading_Error(float target, float current);
+
+#endif /* HEADING_H_ */
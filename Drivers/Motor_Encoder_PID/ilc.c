@@ -0,0 +1,144 @@
+/*
+ * ilc.c
+ *
+ *  迭代学习控制实现 - 按段内里程分格记录误差，逐圈更新前馈
+ */
+
+#include "ilc.h"
+#include "Encoder.h"
+#include "motor_control.h"
+#include <string.h>
+
+// 当前格无效（段外或超出表格）
+#define ILC_BIN_NONE        0xFF
+
+ILC_t g_ilc;
+
+/**
+ * @brief 当前里程（两轮编码器平均计数）
+ */
+static int32_t ILC_Distance(void)
+{
+    return (Encoder_GetCount(0) + Encoder_GetCount(1)) / 2;
+}
+
+/**
+ * @brief 把当前格累加的误差写入误差表
+ */
+static void ILC_Flush(void)
+{
+    if (g_ilc.acc_n > 0 && g_ilc.bin != ILC_BIN_NONE) {
+        g_ilc.err[g_ilc.segment][g_ilc.bin] = (int16_t)(g_ilc.acc / g_ilc.acc_n);
+        g_ilc.seen[g_ilc.segment][g_ilc.bin >> 3] |= (uint8_t)(1u << (g_ilc.bin & 7));
+    }
+    g_ilc.acc = 0;
+    g_ilc.acc_n = 0;
+}
+
+/**
+ * @brief 清空前馈表和误差表（开始新的多圈运行时调用）
+ */
+void ILC_Init(void)
+{
+    memset(&g_ilc, 0, sizeof(g_ilc));
+    g_ilc.bin = ILC_BIN_NONE;
+}
+
+/**
+ * @brief 开始一段直线
+ * @param segment 段号（每圈按相同顺序编号），超出ILC_MAX_SEGMENTS时本段不学习
+ */
+void ILC_BeginSegment(uint8_t segment)
+{
+    g_ilc.active = false;
+    if (segment >= ILC_MAX_SEGMENTS) {
+        return;
+    }
+    g_ilc.segment = segment;
+    g_ilc.bin = ILC_BIN_NONE;
+    g_ilc.acc = 0;
+    g_ilc.acc_n = 0;
+    g_ilc.start_count = ILC_Distance();
+    g_ilc.bins_per_pulse = MotorControl_GetMmPerPulse() * (1.0f / ILC_BIN_MM);
+    g_ilc.active = true;
+}
+
+/**
+ * @brief 结束当前段（进入弯道前调用）
+ * @note 先停用再写表，控制中断看到active为false后不会再修改累加器
+ */
+void ILC_EndSegment(void)
+{
+    if (!g_ilc.active) {
+        return;
+    }
+    g_ilc.active = false;
+    ILC_Flush();
+    g_ilc.bin = ILC_BIN_NONE;
+}
+
+/**
+ * @brief 一圈结束，用本圈误差更新前馈表
+ * @note 只更新本圈采到样本的格；在车停下后调用（浮点运算，不在中断中）
+ */
+void ILC_EndLap(void)
+{
+    uint8_t s, b, e;
+
+    ILC_EndSegment();
+
+    for (s = 0; s < ILC_MAX_SEGMENTS; s++) {
+        for (b = 0; b < ILC_BINS; b++) {
+            // 第b格的前馈要消除的是它在ILC_LEAD_BINS格之后造成的误差
+            e = (b + ILC_LEAD_BINS < ILC_BINS) ? b + ILC_LEAD_BINS : ILC_BINS - 1;
+            if (!(g_ilc.seen[s][e >> 3] & (1u << (e & 7)))) {
+                continue;
+            }
+            float ff = ILC_FORGET * (float)g_ilc.ff[s][b] - ILC_LEARN_GAIN * (float)g_ilc.err[s][e];
+            if (ff > ILC_FF_LIMIT * (1 << ILC_Q)) {
+                ff = ILC_FF_LIMIT * (1 << ILC_Q);
+            } else if (ff < -ILC_FF_LIMIT * (1 << ILC_Q)) {
+                ff = -ILC_FF_LIMIT * (1 << ILC_Q);
+            }
+            g_ilc.ff[s][b] = (int16_t)ff;
+        }
+    }
+    memset(g_ilc.seen, 0, sizeof(g_ilc.seen));
+}
+
+/**
+ * @brief 控制周期调用：记录线位置误差，返回当前位置的前馈修正量
+ * @param line_error 线位置（Q16，与循迹PID的反馈相同，0为居中）
+ * @return 前馈修正量（Q16，与循迹PID输出同单位，加到line_correction上），段外返回0
+ * @note 在TIMA1中断中调用，只有换格时做一次整数除法
+ */
+q16_t ILC_Step(q16_t line_error)
+{
+    int32_t d;
+    uint32_t bin;
+
+    if (!g_ilc.active) {
+        return 0;
+    }
+
+    d = ILC_Distance() - g_ilc.start_count;
+    if (d < 0) {
+        d = -d;
+    }
+    bin = (uint32_t)((float)d * g_ilc.bins_per_pulse);
+    if (bin >= ILC_BINS) {
+        // 超出表格：不学习也不施加前馈
+        ILC_Flush();
+        g_ilc.bin = ILC_BIN_NONE;
+        return 0;
+    }
+
+    if (bin != g_ilc.bin) {
+        ILC_Flush();
+        g_ilc.bin = (uint8_t)bin;
+    }
+    g_ilc.acc += line_error >> (16 - ILC_Q);
+    g_ilc.acc_n++;
+
+    return (q16_t)g_ilc.ff[g_ilc.segment][bin] * (1 << (16 - ILC_Q));
+}
@@ -0,0 +1,58 @@
+/*
+ * ilc.h
+ *
+ *  迭代学习控制（ILC）- 循迹修正的逐圈前馈
+ *
+ *  同一条赛道每圈在相同位置遇到相同的扰动（线的弯折、地面接缝、车轮打滑），循迹PID每圈都从零开始纠正。
+ *  本模块按“第几段直线 + 段内里程”把线位置误差分格记录下来，一圈结束后更新每格的前馈修正量：
+ *      ff[k+1](i) = ILC_FORGET · ff[k](i) - ILC_LEARN_GAIN · e[k](i)
+ *  其中e[k](i)取第i格之后ILC_LEAD_BINS格的误差（补偿电机和车体的响应滞后），下一圈在第i格施加，误差逐圈减小。
+ *  遗忘因子保证前馈有界、对偶然扰动不敏感。
+ *
+ *  用法：
+ *  - 每段直线开始时ILC_BeginSegment(段号)，转弯前ILC_EndSegment()（弯道里不学习）
+ *  - 循迹控制中line_correction += ILC_Step(线位置)（MotorControl_Update在MOTOR_LINE_ILC=1时已接入）
+ *  - 一圈结束（车已停）调用ILC_EndLap()更新前馈表
+ *
+ *  表格固定大小：ILC_MAX_SEGMENTS段 × ILC_BINS格，每格ILC_BIN_MM，超出部分不学习。
+ */
+
+#ifndef ILC_H_
+#define ILC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid.h"
+
+#define ILC_MAX_SEGMENTS    8       // 最多段数
+#define ILC_BINS            32      // 每段格数
+#define ILC_BIN_MM          25.0f   // 每格长度（mm），每段覆盖800mm
+#define ILC_LEAD_BINS       0       // 学习时误差滞后的格数（响应滞后超过一格长度时再加大）
+#define ILC_LEARN_GAIN      0.5f    // 学习增益（修正量/线位置）
+#define ILC_FORGET          0.95f   // 遗忘因子
+#define ILC_FF_LIMIT        10.0f   // 前馈限幅（修正量，循迹PID输出限幅为20）
+#define ILC_Q               8       // 表格定点小数位数
+
+// ILC数据（前馈表和误差表为Q8定点）
+typedef struct {
+    int16_t ff[ILC_MAX_SEGMENTS][ILC_BINS];     // 前馈修正量
+    int16_t err[ILC_MAX_SEGMENTS][ILC_BINS];    // 本圈各格平均线位置误差
+    uint8_t seen[ILC_MAX_SEGMENTS][ILC_BINS / 8]; // 本圈采到样本的格（位图）
+    int32_t start_count;        // 段起点里程（两轮编码器平均计数）
+    float bins_per_pulse;       // 每个编码器脉冲对应的格数（段开始时按标定后的每脉冲里程计算）
+    int32_t acc;                // 当前格误差累加（Q8）
+    uint16_t acc_n;             // 当前格样本数
+    uint8_t segment;            // 当前段号
+    uint8_t bin;                // 当前格
+    volatile bool active;       // 段内学习中（由主循环开关，中断读取）
+} ILC_t;
+
+extern ILC_t g_ilc;
+
+void ILC_Init(void);
+void ILC_BeginSegment(uint8_t segment);
+void ILC_EndSegment(void);
+void ILC_EndLap(void);
+q16_t ILC_Step(q16_t line_error);
+
+#endif /* ILC_H_ */
@@ -9,11 +9,19 @@
  *  3. MOTOR_MODE_SPEED_CONTROL   - 直接速度控制（用于精确转弯）
  *  4. MOTOR_MODE_MANUAL          - 手动控制模式
  *  5. MOTOR_MODE_STOP            - 停止模式
+ *  6. MOTOR_MODE_TURN            - 陀螺仪闭环转向（梯形角速度规划 + 循迹传感器捕获）
+ *  7. MOTOR_MODE_CORNER          - 圆弧过弯（循迹 → 差速圆弧 → 循迹，全程不停车）
+ *
+ *  速度环以mm/s为单位：编码器速度（PPS）乘以各轮标定后的每脉冲里程作为反馈，
+ *  标定只改变里程换算，不需要重新整定速度环增益。
  */
 
 #include "motor_control.h"
 #include "Encoder.h"
 #include "linetracker.h"
+#include "heading.h"
+#include "fast_math.h"
+#include "ilc.h"
 #include <math.h>
 
 // 循迹PID控制器参数设置
@@ -23,28 +31,131 @@
 #define LINE_PID_INT_LIMIT  100.0f // 积分限幅
 #define LINE_PID_OUT_LIMIT  20.0f  // 输出限幅
 
-// Yaw角PID控制器参数设置
-#define YAW_PID_KP          1.0f
+// Yaw角PID控制器参数设置（输入为度，输出为两轮速度差的一半，mm/s）
+#define YAW_PID_KP          0.14f
 #define YAW_PID_KI          0.0f
-#define YAW_PID_KD          0.2f
+#define YAW_PID_KD          0.028f
 #define YAW_PID_INT_LIMIT   200.0f
-#define YAW_PID_OUT_LIMIT   100.0f
+#define YAW_PID_OUT_LIMIT   14.0f
 
-// 速度环PID控制器参数设置
-#define SPEED_PID_KP        1.2f
-#define SPEED_PID_KI        0.2f
-#define SPEED_PID_KD        0.1f
-#define SPEED_PID_INT_LIMIT 50.0f
+// 速度环PID控制器参数设置（输入为mm/s，输出为PWM占空比%）
+// 由原来以PPS整定的参数（1.2/0.2/0.1，积分限幅50）按名义里程换算，闭环特性不变
+#define SPEED_PID_KP        8.56f
+#define SPEED_PID_KI        1.43f
+#define SPEED_PID_KD        0.71f
+#define SPEED_PID_INT_LIMIT 7.0f
 #define SPEED_PID_OUT_LIMIT 100.0f
 
-// 添加最大速度限制，防止电机跑满导致失控
-#define MAX_MOTOR_SPEED 45.0f
+// 最大PWM占空比限制，防止电机跑满导致失控
+#define MAX_MOTOR_PWM 45.0f
+
+// 最大车轮目标速度（mm/s）
+#define MAX_MOTOR_SPEED 6.3f
+
+// 控制中断中使用的Q16常量
+#define MAX_MOTOR_PWM_Q16       Q16_FROM_FLOAT(MAX_MOTOR_PWM)
+#define MAX_MOTOR_SPEED_Q16     Q16_FROM_FLOAT(MAX_MOTOR_SPEED)
+#define LINE_PID_OUT_LIMIT_Q16  Q16_FROM_FLOAT(LINE_PID_OUT_LIMIT)
+#define LINE_RATIO_Q16          Q16_FROM_FLOAT(1.0f / LINE_PID_OUT_LIMIT)   // 循迹修正量换算为差速比例
+
+// 速度环反馈来源：1=M/T法精确速度（低速分辨率高），0=10ms脉冲计数速度
+#define MOTOR_SPEED_FEEDBACK_PRECISE 1
+
+// 循迹环反馈来源：1=滤波后的高分辨率线位置（丢线时短时外推），0=位图重心（5的整数倍阶梯）
+#define MOTOR_LINE_FEEDBACK_FILTERED 1
+
+// 循迹修正叠加迭代学习前馈（ilc.h，只在ILC_BeginSegment开启的直线段内生效）
+#define MOTOR_LINE_ILC 1
 
-// 添加电机平衡因子，用于补偿左右电机速度差异
-#define MOTOR_BALANCE_FACTOR 1.0f
+// 默认PID计算引擎（Q16定点在无FPU的M0+上比软件浮点快得多）
+#define MOTOR_PID_DEFAULT_ENGINE PID_ENGINE_Q16
+
+// 控制周期（MotorControl_Update在10ms定时器中断中调用）
+#define MOTOR_CONTROL_PERIOD_S 0.01f
+
+// 速度设定值规划：基础速度和直接速度控制的目标阶跃经S形规划（Q16定点，在控制中断中计算）后送入速度环，
+// 避免起步、出弯时速度PID饱和导致打滑和航向偏差
+#define MOTOR_PROFILE_ENABLE 1
+#define MOTOR_PROFILE_ACCEL  12.6f     // 加速度限制（mm/s²），0→6.3mm/s约0.6s
+#define MOTOR_PROFILE_JERK   84.0f     // 加加速度限制（mm/s³），0表示梯形规划
+
+// 陀螺仪闭环转向参数（角度单位：度）
+// 角速度和角加速度上限由车轮能力换算：轮速 = ω·(轮距/2)，前馈最多用到MAX_MOTOR_SPEED的TURN_RATE_HEADROOM，
+// 余量留给航向误差修正；角加速度对应车轮加速度MOTOR_PROFILE_ACCEL，与直线起步一致
+#define TURN_RATE_HEADROOM      0.8f    // 前馈可用的最大轮速比例
+#define TURN_MIN_RATE_FRAC      0.2f    // 减速段最低角速度（占本次最大角速度的比例），保证规划能走到终点
+#define TURN_KP                 1.12f   // 航向误差比例增益（(mm/s)/度）
+#define TURN_TOLERANCE_DEG      2.0f    // 规划结束后航向误差小于此值即完成
+#define TURN_CAPTURE_WINDOW_DEG 20.0f   // 距目标此角度以内，中间传感器看到线即完成
+#define TURN_CAPTURE_EXTRA_DEG  25.0f   // 到达目标仍未看到线时，最多再低速多转的角度
+#define TURN_CAPTURE_RATE_FRAC  0.5f    // 寻线阶段角速度（占本次最大角速度的比例）
+#define TURN_TIMEOUT_MS         3000    // 转向超时余量（在按规划估算的转向时间之外）
+
+// 圆弧过弯参数
+#define CORNER_MIN_RADIUS_MM    60.0f   // 最小圆弧半径（车轴已越过切点时用它，出弯后由循迹修正偏移）
+#define CORNER_MAX_RADIUS_MM    200.0f  // 最大圆弧半径（离转角更远时先直行再入弧）
+#define CORNER_LAT_ACCEL_MMPS2  0.25f   // 允许的向心加速度（mm/s²），入弯速度决定半径 R = v²/a
+                                        // （MAX_MOTOR_SPEED约对应160mm，4.2约对应70mm）
+#define CORNER_BLEND_DEG        25.0f   // 距转角此角度以内看到线在中间附近即交回循迹
+#define CORNER_CAPTURE_POS      20      // 交回循迹要求的线位置范围（linePosition绝对值）
+#define CORNER_OVERRUN_DEG      30.0f   // 超过转角此角度仍没看到线也交回循迹（由循迹自行寻线）
 
 Motor_Control_t g_motorControl;
 
+/**
+ * @brief 车体角速度（deg/s）换算为原地转向时的车轮速度（mm/s）：轮速 = ω·(轮距/2)
+ */
+static float MotorControl_WheelSpeedPerDps(void)
+{
+    return g_motorControl.track_width * (PI / 360.0f);
+}
+
+/**
+ * @brief 原地转向能跟踪的最大角速度（deg/s），由MAX_MOTOR_SPEED和当前轮距换算
+ */
+float MotorControl_GetMaxTurnRate(void)
+{
+    return MAX_MOTOR_SPEED * TURN_RATE_HEADROOM / MotorControl_WheelSpeedPerDps();
+}
+
+/**
+ * @brief Q16限幅
+ */
+static q16_t MotorControl_Clamp(q16_t x, q16_t lo, q16_t hi)
+{
+    return (x > hi) ? hi : ((x < lo) ? lo : x);
+}
+
+/**
+ * @brief 按控制器当前选择的引擎执行一次PID计算
+ * @param id PID控制器编号
+ * @param target 目标值（Q16）
+ * @param actual 实际值（Q16）
+ * @return PID输出值（Q16）
+ * @note 控制中断中的设定值和反馈全程为Q16，定点引擎不做任何浮点运算；浮点引擎在这里转换
+ */
+static q16_t MotorControl_RunPID(Motor_PID_Id_t id, q16_t target, q16_t actual)
+{
+    PID_Controller_t *pid;
+    PID_Controller_q16_t *pid_q16;
+
+    switch (id) {
+        case MOTOR_PID_LINE:    pid = &g_motorControl.line_pid;    pid_q16 = &g_motorControl.line_pid_q16;    break;
+        case MOTOR_PID_YAW:     pid = &g_motorControl.yaw_pid;     pid_q16 = &g_motorControl.yaw_pid_q16;     break;
+        case MOTOR_PID_SPEED_L: pid = &g_motorControl.speed_pid_L; pid_q16 = &g_motorControl.speed_pid_L_q16; break;
+        case MOTOR_PID_SPEED_R: pid = &g_motorControl.speed_pid_R; pid_q16 = &g_motorControl.speed_pid_R_q16; break;
+        default: return 0;
+    }
+
+    if (g_motorControl.pid_engine[id] == PID_ENGINE_Q16) {
+        PID_Q16_SetTarget(pid_q16, target);
+        return PID_Q16_Calculate(pid_q16, actual);
+    }
+
+    PID_SetTarget(pid, Q16_TO_FLOAT(target));
+    return Q16_FROM_FLOAT(PID_Calculate(pid, Q16_TO_FLOAT(actual)));
+}
+
 /**
  * @brief 初始化电机控制器
  * 
@@ -71,23 +182,76 @@ void MotorControl_Init(void)
     // 右轮速度PID控制器用于精确控制右轮转速
     PID_Init(&g_motorControl.speed_pid_R, SPEED_PID_KP, SPEED_PID_KI, SPEED_PID_KD, SPEED_PID_INT_LIMIT, SPEED_PID_OUT_LIMIT);
 
+    // 定点版本使用相同参数，运行时可通过MotorControl_SetPIDEngine逐个切换
+    PID_Q16_Init(&g_motorControl.line_pid_q16, LINE_PID_KP, LINE_PID_KI, LINE_PID_KD, LINE_PID_INT_LIMIT, LINE_PID_OUT_LIMIT);
+    PID_Q16_Init(&g_motorControl.yaw_pid_q16, YAW_PID_KP, YAW_PID_KI, YAW_PID_KD, YAW_PID_INT_LIMIT, YAW_PID_OUT_LIMIT);
+    PID_Q16_Init(&g_motorControl.speed_pid_L_q16, SPEED_PID_KP, SPEED_PID_KI, SPEED_PID_KD, SPEED_PID_INT_LIMIT, SPEED_PID_OUT_LIMIT);
+    PID_Q16_Init(&g_motorControl.speed_pid_R_q16, SPEED_PID_KP, SPEED_PID_KI, SPEED_PID_KD, SPEED_PID_INT_LIMIT, SPEED_PID_OUT_LIMIT);
+    for (int i = 0; i < MOTOR_PID_COUNT; i++) {
+        g_motorControl.pid_engine[i] = MOTOR_PID_DEFAULT_ENGINE;
+    }
+
+    // 里程标定（默认按头文件中的标定系数和轮距）
+    MotorControl_SetWheelCalibration(MOTOR_WHEEL_CAL_L, MOTOR_WHEEL_CAL_R);
+    MotorControl_SetTrackWidth(MOTOR_TRACK_WIDTH_MM);
+
     // 设置初始状态
     g_motorControl.mode = MOTOR_MODE_STOP;
-    g_motorControl.base_speed = 20.0f;
+    g_motorControl.base_speed = 2.8f;
     g_motorControl.target_yaw = 0.0f;
     g_motorControl.left_speed_target = 0.0f;
     g_motorControl.right_speed_target = 0.0f;
+    g_motorControl.base_speed_q16 = Q16_FROM_FLOAT(g_motorControl.base_speed);
+    g_motorControl.turn.status = MOTOR_TURN_IDLE;
+    g_motorControl.turn.capture = true;
+    Setpoint_Init(&g_motorControl.base_sp, MOTOR_PROFILE_ACCEL, MOTOR_PROFILE_JERK, MOTOR_CONTROL_PERIOD_S);
+    Setpoint_Init(&g_motorControl.wheel_sp, MOTOR_PROFILE_ACCEL, MOTOR_PROFILE_JERK, MOTOR_CONTROL_PERIOD_S);
     
     // 设置循迹PID的目标值为0（保持在线中央）
     PID_SetTarget(&g_motorControl.line_pid, 0.0f);
 }
 
+/**
+ * @brief 规划直接速度控制的过渡：从当前送入速度环的目标平滑过渡到left/right_speed_target
+ * @note 两轮共用一个进度规划器，按各自变化量缩放，同时开始、同时到达，过渡期间差速比例不变。
+ *       在主循环上下文调用，写入期间关中断，控制中断不会读到一半新一半旧的参数
+ */
+static void MotorControl_PlanWheels(void)
+{
+    q16_t from[2], delta[2], span;
+    uint32_t primask;
+    int i;
+
+    from[0] = g_motorControl.wheel_ref[0];
+    from[1] = g_motorControl.wheel_ref[1];
+    delta[0] = Q16_FROM_FLOAT(g_motorControl.left_speed_target) - from[0];
+    delta[1] = Q16_FROM_FLOAT(g_motorControl.right_speed_target) - from[1];
+    span = (delta[0] >= 0) ? delta[0] : -delta[0];
+    if (((delta[1] >= 0) ? delta[1] : -delta[1]) > span) {
+        span = (delta[1] >= 0) ? delta[1] : -delta[1];
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for (i = 0; i < 2; i++) {
+        g_motorControl.wheel_target[i] = from[i] + delta[i];
+        g_motorControl.wheel_from[i] = from[i];
+        g_motorControl.wheel_scale[i] = (span > 0) ? Q16_FROM_FLOAT((float)delta[i] / (float)span) : 0;
+    }
+    g_motorControl.wheel_span = span;
+    Setpoint_Reset(&g_motorControl.wheel_sp, 0);
+    __set_PRIMASK(primask);
+}
+
 /**
  * @brief 设置电机控制模式
  * @param mode 新的控制模式
  */
 void MotorControl_SetMode(Motor_Mode_t mode)
 {
+    if (mode == MOTOR_MODE_SPEED_CONTROL && g_motorControl.mode != MOTOR_MODE_SPEED_CONTROL) {
+        MotorControl_PlanWheels();
+    }
     g_motorControl.mode = mode;
     if (mode == MOTOR_MODE_STOP) {
         MotorControl_Stop();
@@ -96,7 +260,7 @@ void MotorControl_SetMode(Motor_Mode_t mode)
 
 /**
  * @brief 设置基础速度
- * @param speed 基础速度值 (0.0 - 50.0)
+ * @param speed 基础速度（mm/s，0 - MAX_MOTOR_SPEED）
  */
 void MotorControl_SetBaseSpeed(float speed)
 {
@@ -107,11 +271,12 @@ void MotorControl_SetBaseSpeed(float speed)
         speed = 0.0f;
     }
     g_motorControl.base_speed = speed;
+    g_motorControl.base_speed_q16 = Q16_FROM_FLOAT(speed);
 }
 
 /**
  * @brief 设置目标Yaw角
- * @param yaw 目标Yaw角
+ * @param yaw 目标Yaw角（度），±180内的角度或连续航向（Heading_Get）均可，控制时取最短路径
  */
 void MotorControl_SetTargetYaw(float yaw)
 {
@@ -121,13 +286,403 @@ void MotorControl_SetTargetYaw(float yaw)
 
 /**
  * @brief 设置左右轮目标速度（用于差速转弯等精确控制）
- * @param left_speed 左轮目标速度
- * @param right_speed 右轮目标速度
+ * @param left_speed 左轮目标速度（mm/s）
+ * @param right_speed 右轮目标速度（mm/s）
+ * @note MOTOR_PROFILE_ENABLE时两轮从当前目标同步过渡到新目标；每次调用都从变化率0重新规划，
+ *       需要连续改变速度时用基础速度模式
  */
 void MotorControl_SetSpeedTarget(float left_speed, float right_speed)
 {
     g_motorControl.left_speed_target = left_speed;
     g_motorControl.right_speed_target = right_speed;
+    MotorControl_PlanWheels();
+}
+
+/**
+ * @brief 按车体速度设置左右轮目标速度（MOTOR_MODE_SPEED_CONTROL）
+ * @param v 车体中心线速度（mm/s，前进为正）
+ * @param w 车体角速度（deg/s，逆时针/左转为正）
+ * @note 左右轮 = v ∓ ω·(轮距/2)，轮距取标定后的有效轮距
+ */
+void MotorControl_SetVelocity(float v, float w)
+{
+    float dv = w * MotorControl_WheelSpeedPerDps();
+
+    MotorControl_SetSpeedTarget(v - dv, v + dv);
+}
+
+/**
+ * @brief 设置每轮标定系数
+ * @param cal_L 左轮标定系数（实际里程 / 名义里程）
+ * @param cal_R 右轮标定系数
+ * @note 非正数视为未标定，按1.0处理
+ */
+void MotorControl_SetWheelCalibration(float cal_L, float cal_R)
+{
+    g_motorControl.wheel_cal[0] = (cal_L > 0.0f) ? cal_L : 1.0f;
+    g_motorControl.wheel_cal[1] = (cal_R > 0.0f) ? cal_R : 1.0f;
+    g_motorControl.mm_per_pulse[0] = MOTOR_MM_PER_PULSE_NOMINAL * g_motorControl.wheel_cal[0];
+    g_motorControl.mm_per_pulse[1] = MOTOR_MM_PER_PULSE_NOMINAL * g_motorControl.wheel_cal[1];
+    g_motorControl.mm_per_pulse_q16[0] = Q16_FROM_FLOAT(g_motorControl.mm_per_pulse[0]);
+    g_motorControl.mm_per_pulse_q16[1] = Q16_FROM_FLOAT(g_motorControl.mm_per_pulse[1]);
+}
+
+/**
+ * @brief 设置有效轮距
+ * @param track_width 轮距（mm），非正数时恢复MOTOR_TRACK_WIDTH_MM
+ */
+void MotorControl_SetTrackWidth(float track_width)
+{
+    g_motorControl.track_width = (track_width > 0.0f) ? track_width : MOTOR_TRACK_WIDTH_MM;
+}
+
+/**
+ * @brief 直线标定：沿直线行驶（或推行）已知距离后，按两轮编码器计数计算标定系数
+ * @param count_L 左轮编码器计数变化量
+ * @param count_R 右轮编码器计数变化量
+ * @param distance 实际行驶距离（mm，用卷尺测量）
+ * @return true表示标定成功并已生效，false表示计数为0或方向不一致（未修改）
+ * @note 标定系数 = 实际距离 / (计数 × 名义每脉冲里程)，左右轮各自计算，
+ *       同时补偿轮径误差和左右轮差异（代替原来凭经验设置的左右平衡系数）
+ */
+bool MotorControl_CalibrateWheels(int32_t count_L, int32_t count_R, float distance)
+{
+    if (distance == 0.0f || count_L == 0 || count_R == 0 ||
+        (count_L > 0) != (count_R > 0) || (count_L > 0) != (distance > 0.0f)) {
+        return false;
+    }
+
+    MotorControl_SetWheelCalibration(distance / ((float)count_L * MOTOR_MM_PER_PULSE_NOMINAL),
+                                      distance / ((float)count_R * MOTOR_MM_PER_PULSE_NOMINAL));
+    return true;
+}
+
+/**
+ * @brief 轮距标定：原地旋转已知角度后，按两轮里程差计算有效轮距
+ * @param count_L 左轮编码器计数变化量
+ * @param count_R 右轮编码器计数变化量
+ * @param angle 实际转过的角度（度，逆时针为正，用陀螺仪连续航向或地面标记测量）
+ * @return true表示标定成功并已生效，false表示角度或里程差为0、方向不一致（未修改）
+ * @note 有效轮距 = (右轮里程 - 左轮里程) / 转角(rad)，包含轮胎侧滑等效应，
+ *       应在直线标定之后进行（里程使用当前标定系数）
+ */
+bool MotorControl_CalibrateTrackWidth(int32_t count_L, int32_t count_R, float angle)
+{
+    float diff = (float)count_R * g_motorControl.mm_per_pulse[1] - (float)count_L * g_motorControl.mm_per_pulse[0];
+
+    if (angle == 0.0f || diff == 0.0f || (diff > 0.0f) != (angle > 0.0f)) {
+        return false;
+    }
+
+    MotorControl_SetTrackWidth(diff / (angle / FAST_MATH_RAD2DEG));
+    return true;
+}
+
+/**
+ * @brief 获取车轮速度
+ * @param motor_id 电机编号（0=左轮，1=右轮）
+ * @return 车轮速度（mm/s，M/T法速度 × 标定后的每脉冲里程）
+ */
+float MotorControl_GetWheelSpeed(uint8_t motor_id)
+{
+    if (motor_id > 1) return 0.0f;
+    return Encoder_GetSpeed_Precise(motor_id) * g_motorControl.mm_per_pulse[motor_id];
+}
+
+/**
+ * @brief 获取车轮里程
+ * @param motor_id 电机编号（0=左轮，1=右轮）
+ * @return 编码器累计计数对应的里程（mm）
+ */
+float MotorControl_GetWheelDistance(uint8_t motor_id)
+{
+    if (motor_id > 1) return 0.0f;
+    return (float)Encoder_GetCount(motor_id) * g_motorControl.mm_per_pulse[motor_id];
+}
+
+/**
+ * @brief 获取两轮平均的每脉冲里程
+ * @return 标定后的每脉冲里程（mm），两轮平均计数乘以它即为车体中心里程
+ * @note 路口检测、赛道地图、ILC按两轮平均计数计算里程，都用这个值换算，与速度环的标定保持一致
+ */
+float MotorControl_GetMmPerPulse(void)
+{
+    return 0.5f * (g_motorControl.mm_per_pulse[0] + g_motorControl.mm_per_pulse[1]);
+}
+
+/**
+ * @brief 选择指定PID控制器的计算引擎
+ * @param id PID控制器编号
+ * @param engine PID_ENGINE_FLOAT 或 PID_ENGINE_Q16
+ * @note 切换时同时复位两种引擎的状态，避免残留积分造成输出跳变
+ */
+void MotorControl_SetPIDEngine(Motor_PID_Id_t id, PID_Engine_t engine)
+{
+    if (id >= MOTOR_PID_COUNT) return;
+
+    switch (id) {
+        case MOTOR_PID_LINE:    PID_Reset(&g_motorControl.line_pid);    PID_Q16_Reset(&g_motorControl.line_pid_q16);    break;
+        case MOTOR_PID_YAW:     PID_Reset(&g_motorControl.yaw_pid);     PID_Q16_Reset(&g_motorControl.yaw_pid_q16);     break;
+        case MOTOR_PID_SPEED_L: PID_Reset(&g_motorControl.speed_pid_L); PID_Q16_Reset(&g_motorControl.speed_pid_L_q16); break;
+        case MOTOR_PID_SPEED_R: PID_Reset(&g_motorControl.speed_pid_R); PID_Q16_Reset(&g_motorControl.speed_pid_R_q16); break;
+        default: break;
+    }
+    g_motorControl.pid_engine[id] = engine;
+}
+
+/**
+ * @brief 开始陀螺仪闭环转向
+ * @param angle 要转过的角度（度，逆时针/左转为正，可以超过360）
+ * @param max_rate 最大角速度（deg/s），超过MotorControl_GetMaxTurnRate时按它限幅
+ * @note 立即返回，转向在控制中断中执行，用MotorControl_GetTurnStatus查询结果。
+ *       角速度按梯形规划（角加速度对应车轮加速度MOTOR_PROFILE_ACCEL），
+ *       车轮速度 = 规划角速度前馈 + 航向误差比例修正，限幅到±MAX_MOTOR_SPEED，
+ *       航向取连续航向（Heading_Get），跨越±180°不受影响。
+ *       启用捕获时（默认），末段TURN_CAPTURE_WINDOW_DEG以内中间传感器看到线即停止；
+ *       到达目标仍未看到线则低速多转最多TURN_CAPTURE_EXTRA_DEG寻线。
+ *       没有航向数据时直接返回MOTOR_TURN_TIMEOUT，调用者可退回传感器转向。
+ */
+void MotorControl_TurnBy(float angle, float max_rate)
+{
+    Motor_Turn_t *t = &g_motorControl.turn;
+    float rate_limit = MotorControl_GetMaxTurnRate();
+    float duration;
+
+    g_motorControl.mode = MOTOR_MODE_STOP;
+    MotorControl_Stop();
+
+    if (!Heading_IsValid() || max_rate <= 0.0f) {
+        t->status = MOTOR_TURN_TIMEOUT;
+        return;
+    }
+    if (max_rate > rate_limit) {
+        max_rate = rate_limit;
+    }
+
+    t->start = Heading_Get();
+    t->angle = angle;
+    t->max_rate = max_rate;
+    t->accel = MOTOR_PROFILE_ACCEL / MotorControl_WheelSpeedPerDps();
+    t->rate = 0.0f;
+    t->ref = 0.0f;
+    t->ticks = 0;
+
+    // 超时 = 梯形规划时间 + 寻线时间 + 余量（低速转向一圈可能要几十秒，不能用固定超时）
+    duration = fabsf(angle) / max_rate + max_rate / t->accel +
+               TURN_CAPTURE_EXTRA_DEG / (max_rate * TURN_CAPTURE_RATE_FRAC);
+    t->timeout_ticks = (uint32_t)(duration / MOTOR_CONTROL_PERIOD_S) + TURN_TIMEOUT_MS / 10;
+    t->phase = MOTOR_TURN_PHASE_PROFILE;
+    t->status = MOTOR_TURN_BUSY;
+    g_motorControl.mode = MOTOR_MODE_TURN;
+}
+
+/**
+ * @brief 设置转向末段是否用循迹传感器捕获线
+ * @param enable true=看到线即结束（循迹路口转弯），false=只按陀螺仪角度结束
+ */
+void MotorControl_SetTurnCapture(bool enable)
+{
+    g_motorControl.turn.capture = enable;
+}
+
+/**
+ * @brief 查询转向状态
+ */
+Motor_Turn_Status_t MotorControl_GetTurnStatus(void)
+{
+    return g_motorControl.turn.status;
+}
+
+/**
+ * @brief 结束转向并停车
+ */
+static void MotorControl_TurnFinish(Motor_Turn_Status_t status)
+{
+    g_motorControl.turn.status = status;
+    g_motorControl.mode = MOTOR_MODE_STOP;
+    MotorControl_Stop();
+}
+
+/**
+ * @brief 转向的一个控制周期：推进角速度规划，计算左右轮目标速度
+ * @param line 本周期的循迹数据快照
+ * @param left_speed_target 输出左轮目标速度（mm/s，Q16）
+ * @param right_speed_target 输出右轮目标速度（mm/s，Q16）
+ * @return true表示继续转向，false表示转向已结束（已停车）
+ * @note 航向为浮点，规划在浮点下进行，只在输出时换算一次Q16
+ */
+static bool MotorControl_TurnStep(const LineTracker_t *line, q16_t *left_speed_target, q16_t *right_speed_target)
+{
+    Motor_Turn_t *t = &g_motorControl.turn;
+    float dir = (t->angle >= 0.0f) ? 1.0f : -1.0f;
+    float target = fabsf(t->angle);
+    float turned = (Heading_Get() - t->start) * dir;      // 沿转向方向实际转过的角度
+    bool centered = line->sensorValue[2] && line->sensorValue[3];   // 与传感器转向的完成判据一致
+
+    if (++t->ticks > t->timeout_ticks) {
+        MotorControl_TurnFinish(MOTOR_TURN_TIMEOUT);
+        return false;
+    }
+
+    // 末段看到线：捕获完成
+    if (t->capture && centered && turned >= target - TURN_CAPTURE_WINDOW_DEG) {
+        MotorControl_TurnFinish(MOTOR_TURN_DONE);
+        return false;
+    }
+
+    switch (t->phase) {
+        case MOTOR_TURN_PHASE_PROFILE:
+        {
+            // 梯形规划：剩余角度不足以按t->accel减速到0时开始减速
+            float remaining = target - t->ref;
+            float min_rate = t->max_rate * TURN_MIN_RATE_FRAC;
+            if (t->rate * t->rate >= 2.0f * t->accel * remaining) {
+                t->rate -= t->accel * MOTOR_CONTROL_PERIOD_S;
+                if (t->rate < min_rate) t->rate = min_rate;
+            } else {
+                t->rate += t->accel * MOTOR_CONTROL_PERIOD_S;
+                if (t->rate > t->max_rate) t->rate = t->max_rate;
+            }
+            t->ref += t->rate * MOTOR_CONTROL_PERIOD_S;
+            if (t->ref >= target) {
+                t->ref = target;
+                t->rate = 0.0f;
+                t->phase = MOTOR_TURN_PHASE_SETTLE;
+            }
+            break;
+        }
+
+        case MOTOR_TURN_PHASE_SETTLE:
+            if (fabsf(target - turned) <= TURN_TOLERANCE_DEG) {
+                if (!t->capture) {
+                    MotorControl_TurnFinish(MOTOR_TURN_DONE);
+                    return false;
+                }
+                t->phase = MOTOR_TURN_PHASE_CAPTURE;
+                t->rate = t->max_rate * TURN_CAPTURE_RATE_FRAC;
+            }
+            break;
+
+        case MOTOR_TURN_PHASE_CAPTURE:
+            // 到达目标角度但线不在中间：低速继续寻线，超过最大附加角度按角度完成
+            t->ref += t->rate * MOTOR_CONTROL_PERIOD_S;
+            if (t->ref >= target + TURN_CAPTURE_EXTRA_DEG) {
+                MotorControl_TurnFinish(MOTOR_TURN_DONE);
+                return false;
+            }
+            break;
+    }
+
+    // 前馈 + 航向误差比例修正，左右轮反向实现原地转向；与其他模式一样限幅到速度环能跟踪的范围
+    q16_t wheel = Q16_FROM_FLOAT(dir * (t->rate * MotorControl_WheelSpeedPerDps() + TURN_KP * (t->ref - turned)));
+    wheel = MotorControl_Clamp(wheel, -MAX_MOTOR_SPEED_Q16, MAX_MOTOR_SPEED_Q16);
+    *left_speed_target = -wheel;
+    *right_speed_target = wheel;
+    return true;
+}
+
+/**
+ * @brief 开始不停车圆弧过弯
+ * @param angle 转角（度，左转为正，通常为±90）
+ * @param overshoot 确认路口时传感器已越过分支线的距离（mm，见TurnDetection_GetTurnOvershoot）
+ * @note 车轴离转角的距离 d = MOTOR_SENSOR_LEAD_MM - overshoot。
+ *       半径按入弯速度（base_speed）取 R = v²/CORNER_LAT_ACCEL_MMPS2，钳位到[CORNER_MIN_RADIUS_MM, CORNER_MAX_RADIUS_MM]；
+ *       圆弧必须在切点之前开始，半径不能超过d：d大于半径时先循迹直行到切点，
+ *       d不够时半径取d（不小于最小半径），过弯速度降到√(a·R)（经设定值规划器平滑减速）。
+ *       内外轮按(R∓轮距/2)/R分配。
+ *       转过(angle - CORNER_BLEND_DEG)后线回到中间附近即切回MOTOR_MODE_LINE_FOLLOWING，
+ *       base_speed不变，出弯直接恢复直线速度。
+ */
+void MotorControl_StartCorner(float angle, float overshoot)
+{
+    Motor_Corner_t *c = &g_motorControl.corner;
+    float d = MOTOR_SENSOR_LEAD_MM - overshoot;
+    float speed = g_motorControl.base_speed;
+    float radius = speed * speed * (1.0f / CORNER_LAT_ACCEL_MMPS2);
+
+    // 按速度确定的半径，受几何距离d限制
+    if (radius > CORNER_MAX_RADIUS_MM) radius = CORNER_MAX_RADIUS_MM;
+    if (radius > d) radius = d;
+    if (radius < CORNER_MIN_RADIUS_MM) radius = CORNER_MIN_RADIUS_MM;
+
+    // 半径被d压小时按向心加速度降速（mm/s）
+    if (speed * speed > CORNER_LAT_ACCEL_MMPS2 * radius) {
+        speed = FastMath_Sqrt(CORNER_LAT_ACCEL_MMPS2 * radius);
+    }
+
+    c->angle = angle;
+    c->radius = radius;
+    c->speed = Q16_FROM_FLOAT(speed);
+    c->k = Q16_FROM_FLOAT(((angle >= 0.0f) ? 0.5f : -0.5f) * g_motorControl.track_width / radius);
+    c->entry = (d > radius) ? d - radius : 0.0f;
+    c->start_count[0] = Encoder_GetCount(0);
+    c->start_count[1] = Encoder_GetCount(1);
+    c->start_heading = Heading_Get();
+    c->phase = (c->entry > 0.0f) ? MOTOR_CORNER_PHASE_ENTRY : MOTOR_CORNER_PHASE_ARC;
+    g_motorControl.mode = MOTOR_MODE_CORNER;
+}
+
+/**
+ * @brief 是否正在圆弧过弯
+ * @return true表示还在过弯，false表示已交回循迹（或被切换到其他模式）
+ */
+bool MotorControl_IsCornering(void)
+{
+    return g_motorControl.mode == MOTOR_MODE_CORNER;
+}
+
+/**
+ * @brief 圆弧过弯的一个控制周期
+ * @param line 本周期的循迹数据快照
+ * @param speed 本周期车体中心速度（mm/s，Q16，规划器输出）
+ * @param left_speed_target 输出左轮目标速度（Q16）
+ * @param right_speed_target 输出右轮目标速度（Q16）
+ * @return true表示本周期仍是圆弧控制，false表示已切回循迹模式（由循迹分支计算本周期目标）
+ */
+static bool MotorControl_CornerStep(const LineTracker_t *line, q16_t speed, q16_t *left_speed_target, q16_t *right_speed_target)
+{
+    Motor_Corner_t *c = &g_motorControl.corner;
+    float dir = (c->angle >= 0.0f) ? 1.0f : -1.0f;
+    int32_t dl = Encoder_GetCount(0) - c->start_count[0];
+    int32_t dr = Encoder_GetCount(1) - c->start_count[1];
+    float sl = (float)dl * g_motorControl.mm_per_pulse[0];
+    float sr = (float)dr * g_motorControl.mm_per_pulse[1];
+
+    if (c->phase == MOTOR_CORNER_PHASE_ENTRY) {
+        if ((sl + sr) * 0.5f < c->entry) {
+            return false;
+        }
+        // 到达切点，开始圆弧
+        c->start_count[0] += dl;
+        c->start_count[1] += dr;
+        c->start_heading = Heading_Get();
+        c->phase = MOTOR_CORNER_PHASE_ARC;
+        sl = sr = 0.0f;
+    }
+
+    // 已转过的角度：优先用连续航向，没有航向数据时用两轮里程差估算
+    float turned;
+    if (Heading_IsValid()) {
+        turned = (Heading_Get() - c->start_heading) * dir;
+    } else {
+        turned = (sr - sl) / g_motorControl.track_width * FAST_MATH_RAD2DEG * dir;
+    }
+
+    float target = fabsf(c->angle);
+    bool centered = line->lineDetected &&
+                    line->linePosition <= CORNER_CAPTURE_POS && line->linePosition >= -CORNER_CAPTURE_POS;
+    if ((turned >= target - CORNER_BLEND_DEG && centered) || turned >= target + CORNER_OVERRUN_DEG) {
+        // 出弯：交回循迹，清掉入弯前的循迹PID历史
+        PID_Reset(&g_motorControl.line_pid);
+        PID_Q16_Reset(&g_motorControl.line_pid_q16);
+        g_motorControl.mode = MOTOR_MODE_LINE_FOLLOWING;
+        return false;
+    }
+
+    // 内外轮速度按半径分配：v·(R ∓ 轮距/2)/R，限制速度目标值（小半径时内轮反转）
+    *left_speed_target = MotorControl_Clamp(q16_mul(speed, Q16_ONE - c->k), -MAX_MOTOR_SPEED_Q16, MAX_MOTOR_SPEED_Q16);
+    *right_speed_target = MotorControl_Clamp(q16_mul(speed, Q16_ONE + c->k), -MAX_MOTOR_SPEED_Q16, MAX_MOTOR_SPEED_Q16);
+    return true;
 }
 
 /**
@@ -141,16 +696,37 @@ void MotorControl_SetSpeedTarget(float left_speed, float right_speed)
  */
 void MotorControl_Update(void)
 {
-    float line_correction = 0;       // 循迹修正值
-    float yaw_correction = 0;        // Yaw角修正值
-    float left_speed_target = 0;    // 左轮目标速度
-    float right_speed_target = 0;   // 右轮目标速度
+    q16_t line_correction = 0;      // 循迹修正值
+    q16_t line_position;            // 循迹反馈（线位置）
+    q16_t yaw_correction = 0;       // Yaw角修正值
+    q16_t left_speed_target = 0;    // 左轮目标速度（mm/s）
+    q16_t right_speed_target = 0;   // 右轮目标速度（mm/s）
+    LineTracker_t line;             // 本周期使用的循迹数据快照
 
-    // 更新循迹传感器数据
+    // 更新循迹传感器数据，并取一份一致的快照供本周期使用
     LineTracker_ReadSensors();
+    LineTracker_GetSnapshot(&line);
     
+    // 基础速度经设定值规划器平滑（圆弧段的目标为过弯速度）
+#if MOTOR_PROFILE_ENABLE
+    q16_t base_target = g_motorControl.base_speed_q16;
+    if (g_motorControl.mode == MOTOR_MODE_CORNER && g_motorControl.corner.phase == MOTOR_CORNER_PHASE_ARC) {
+        base_target = g_motorControl.corner.speed;
+    }
+    q16_t base_speed = Setpoint_Step(&g_motorControl.base_sp, base_target);
+#else
+    q16_t base_speed = (g_motorControl.mode == MOTOR_MODE_CORNER) ? g_motorControl.corner.speed
+                                                                  : g_motorControl.base_speed_q16;
+#endif
+
     // 根据控制模式计算目标速度
     switch (g_motorControl.mode) {
+        case MOTOR_MODE_CORNER:
+            // 圆弧过弯 - 圆弧段直接给出差速目标；入弧前和出弯的这个周期按循迹计算
+            if (MotorControl_CornerStep(&line, base_speed, &left_speed_target, &right_speed_target)) {
+                break;
+            }
+            /* fall through */
         case MOTOR_MODE_LINE_FOLLOWING:
             // 循迹模式 - 根据传感器检测到的线位置调整行驶方向
             
@@ -169,44 +745,66 @@ void MotorControl_Update(void)
             //     line_correction = 8.0f;
             // } else {
             //     // 正常情况下使用PID计算
-                line_correction = PID_Calculate(&g_motorControl.line_pid, g_lineTracker.linePosition);
+#if MOTOR_LINE_FEEDBACK_FILTERED
+                line_position = line.linePositionQ8 * (1 << (16 - LINE_POS_Q));
+#else
+                line_position = Q16_FROM_INT(line.linePosition);
+#endif
+                line_correction = MotorControl_RunPID(MOTOR_PID_LINE, 0, line_position);
             // }
+
+#if MOTOR_LINE_ILC
+            // 叠加上一圈在同一位置学到的前馈修正
+            line_correction = MotorControl_Clamp(line_correction + ILC_Step(line_position),
+                                                 -LINE_PID_OUT_LIMIT_Q16, LINE_PID_OUT_LIMIT_Q16);
+#endif
             
             // 根据线位置偏差计算左右轮速度差值
-            float correction_ratio = line_correction / LINE_PID_OUT_LIMIT;
-            
-            // 按比例调整左右轮速度
-            left_speed_target = g_motorControl.base_speed * (1.0f - correction_ratio);
-            right_speed_target = g_motorControl.base_speed * (1.0f + correction_ratio) * MOTOR_BALANCE_FACTOR;
+            q16_t correction_ratio = q16_mul(line_correction, LINE_RATIO_Q16);
             
-            // 限制速度目标值
-            left_speed_target = left_speed_target > MAX_MOTOR_SPEED ? MAX_MOTOR_SPEED : (left_speed_target < 0) ? 0 : left_speed_target;
-            right_speed_target = right_speed_target > MAX_MOTOR_SPEED ? MAX_MOTOR_SPEED : (right_speed_target < 0) ? 0 : right_speed_target;
+            // 按比例调整左右轮速度，限制速度目标值
+            left_speed_target = MotorControl_Clamp(q16_mul(base_speed, Q16_ONE - correction_ratio), 0, MAX_MOTOR_SPEED_Q16);
+            right_speed_target = MotorControl_Clamp(q16_mul(base_speed, Q16_ONE + correction_ratio), 0, MAX_MOTOR_SPEED_Q16);
             break;
             
         case MOTOR_MODE_YAW_CORRECTION:
             // Yaw角闭环模式 - 通过调整左右轮速度差实现转向控制
-            yaw_correction = PID_Calculate(&g_motorControl.yaw_pid, yaw);
+            // 误差取连续航向到目标的最短路径，±180°边界和多圈累计都不会产生跳变；
+            // 以误差为目标、0为反馈送入PID，定点引擎的输入范围与圈数无关（航向为浮点，在这里换算一次）
+            yaw_correction = MotorControl_RunPID(MOTOR_PID_YAW,
+                                                 Q16_FROM_FLOAT(Heading_Error(g_motorControl.target_yaw, Heading_Get())), 0);
 
-            // 根据Yaw角误差计算左右轮速度差值
-            left_speed_target = g_motorControl.base_speed - yaw_correction;
-            right_speed_target = (g_motorControl.base_speed + yaw_correction) * MOTOR_BALANCE_FACTOR;
-            
-            // 限制速度目标值
-            left_speed_target = (left_speed_target > MAX_MOTOR_SPEED) ? MAX_MOTOR_SPEED : (left_speed_target < -MAX_MOTOR_SPEED) ? -MAX_MOTOR_SPEED : left_speed_target;
-            right_speed_target = (right_speed_target > MAX_MOTOR_SPEED) ? MAX_MOTOR_SPEED : (right_speed_target < -MAX_MOTOR_SPEED) ? -MAX_MOTOR_SPEED : right_speed_target;
+            // 根据Yaw角误差计算左右轮速度差值，限制速度目标值
+            left_speed_target = MotorControl_Clamp(base_speed - yaw_correction, -MAX_MOTOR_SPEED_Q16, MAX_MOTOR_SPEED_Q16);
+            right_speed_target = MotorControl_Clamp(base_speed + yaw_correction, -MAX_MOTOR_SPEED_Q16, MAX_MOTOR_SPEED_Q16);
             break;
 
         case MOTOR_MODE_SPEED_CONTROL:
             // 速度控制模式 - 直接使用设置的左右轮目标速度
-            left_speed_target = g_motorControl.left_speed_target;
-            right_speed_target = g_motorControl.right_speed_target;
+#if MOTOR_PROFILE_ENABLE
+        {
+            // 两轮按同一进度过渡到目标
+            q16_t p = Setpoint_Step(&g_motorControl.wheel_sp, g_motorControl.wheel_span);
+            left_speed_target = g_motorControl.wheel_from[0] + q16_mul(g_motorControl.wheel_scale[0], p);
+            right_speed_target = g_motorControl.wheel_from[1] + q16_mul(g_motorControl.wheel_scale[1], p);
+        }
+#else
+            left_speed_target = g_motorControl.wheel_target[0];
+            right_speed_target = g_motorControl.wheel_target[1];
+#endif
+            break;
+
+        case MOTOR_MODE_TURN:
+            // 陀螺仪闭环转向 - 规划结束或捕获到线后自动停车
+            if (!MotorControl_TurnStep(&line, &left_speed_target, &right_speed_target)) {
+                return;
+            }
             break;
 
         case MOTOR_MODE_MANUAL:
             // 手动模式下，速度由外部直接设置
-            left_speed_target = g_motorControl.base_speed;
-            right_speed_target = g_motorControl.base_speed * MOTOR_BALANCE_FACTOR;
+            left_speed_target = base_speed;
+            right_speed_target = base_speed;
             break;
 
         case MOTOR_MODE_STOP:
@@ -215,24 +813,28 @@ void MotorControl_Update(void)
             return;
     }
 
-    // 速度闭环控制 - 使用编码器反馈实现精确速度控制
-    int32_t current_speed_L = Encoder_GetSpeed_PPS(0);
-    int32_t current_speed_R = Encoder_GetSpeed_PPS(1);
+    g_motorControl.wheel_ref[0] = left_speed_target;
+    g_motorControl.wheel_ref[1] = right_speed_target;
 
-    // 设置左轮速度目标并计算PID输出
-    PID_SetTarget(&g_motorControl.speed_pid_L, left_speed_target);
-    float pwm_L = PID_Calculate(&g_motorControl.speed_pid_L, current_speed_L);
+    // 速度闭环控制 - 使用编码器反馈实现精确速度控制（PPS按各轮标定换算为mm/s）
+    Encoder_Snapshot_t enc;
+    Encoder_GetSnapshot(&enc);
+#if MOTOR_SPEED_FEEDBACK_PRECISE
+    q16_t current_speed_L = q16_mul(enc.speed_precise_q16[0], g_motorControl.mm_per_pulse_q16[0]);
+    q16_t current_speed_R = q16_mul(enc.speed_precise_q16[1], g_motorControl.mm_per_pulse_q16[1]);
+#else
+    q16_t current_speed_L = enc.speed_pps[0] * g_motorControl.mm_per_pulse_q16[0];
+    q16_t current_speed_R = enc.speed_pps[1] * g_motorControl.mm_per_pulse_q16[1];
+#endif
 
-    // 设置右轮速度目标并计算PID输出
-    PID_SetTarget(&g_motorControl.speed_pid_R, right_speed_target);
-    float pwm_R = PID_Calculate(&g_motorControl.speed_pid_R, current_speed_R);
-
-    // 限制PID输出值，防止电机跑满
-    pwm_L = (pwm_L > MAX_MOTOR_SPEED) ? MAX_MOTOR_SPEED : ((pwm_L < -MAX_MOTOR_SPEED) ? -MAX_MOTOR_SPEED : pwm_L);
-    pwm_R = (pwm_R > MAX_MOTOR_SPEED) ? MAX_MOTOR_SPEED : ((pwm_R < -MAX_MOTOR_SPEED) ? -MAX_MOTOR_SPEED : pwm_R);
+    // 设置左右轮速度目标并计算PID输出，限制PID输出值，防止电机跑满
+    q16_t pwm_L = MotorControl_Clamp(MotorControl_RunPID(MOTOR_PID_SPEED_L, left_speed_target, current_speed_L),
+                                     -MAX_MOTOR_PWM_Q16, MAX_MOTOR_PWM_Q16);
+    q16_t pwm_R = MotorControl_Clamp(MotorControl_RunPID(MOTOR_PID_SPEED_R, right_speed_target, current_speed_R),
+                                     -MAX_MOTOR_PWM_Q16, MAX_MOTOR_PWM_Q16);
 
     // 设置电机PWM驱动值
-    Motor_Set_Pwm(pwm_L, pwm_R);
+    Motor_Set_Pwm_Q16(pwm_L, pwm_R);
 }
 
 /**
@@ -247,4 +849,13 @@ void MotorControl_Stop(void)
     PID_Reset(&g_motorControl.yaw_pid);
     PID_Reset(&g_motorControl.speed_pid_L);
     PID_Reset(&g_motorControl.speed_pid_R);
+    PID_Q16_Reset(&g_motorControl.line_pid_q16);
+    PID_Q16_Reset(&g_motorControl.yaw_pid_q16);
+    PID_Q16_Reset(&g_motorControl.speed_pid_L_q16);
+    PID_Q16_Reset(&g_motorControl.speed_pid_R_q16);
+
+    // 设定值从0重新起步
+    Setpoint_Reset(&g_motorControl.base_sp, 0);
+    g_motorControl.wheel_ref[0] = 0;
+    g_motorControl.wheel_ref[1] = 0;
 }
\ No newline at end of file
@@ -7,6 +7,11 @@
  *  - 统一的PID控制框架
  *  - 多种控制模式适应不同场景
  *  - 针对循迹小车优化的参数
+ *
+ *  单位：车轮和车体线速度为mm/s，角速度为deg/s（逆时针/左转为正），角度为度。
+ *  编码器脉冲按 名义值(2π·RR/PULSES_PER_REVOLUTION) × 每轮标定系数 换算为里程，
+ *  标定系数和有效轮距用MotorControl_CalibrateWheels/MotorControl_CalibrateTrackWidth测量
+ *  （流程见Test/test.c中的Test_Wheel_Calibration）。
  */
 
 #ifndef MOTOR_CONTROL_H_
@@ -16,6 +21,7 @@
 #include "linetracker.h"
 #include "mpu6050.h"
 #include "Motor.h"
+#include "Encoder.h"
 
 // 电机控制模式
 typedef enum {
@@ -23,9 +29,82 @@ typedef enum {
     MOTOR_MODE_LINE_FOLLOWING,  // 循迹模式 - 基于7路传感器的PID控制
     MOTOR_MODE_YAW_CORRECTION,  // Yaw角闭环 - 基于MPU6050的方向保持
     MOTOR_MODE_SPEED_CONTROL,   // 速度控制模式 - 直接设置左右轮速度
-    MOTOR_MODE_MANUAL           // 手动控制
+    MOTOR_MODE_MANUAL,          // 手动控制
+    MOTOR_MODE_TURN,            // 陀螺仪闭环转向 - 梯形角速度规划，由MotorControl_TurnBy启动
+    MOTOR_MODE_CORNER           // 圆弧过弯 - 不停车差速过弯，结束后自动回到循迹模式
 } Motor_Mode_t;
 
+// 车轮轮距（两轮接地点中心距离，单位mm，按实车测量），用于角速度与轮速换算
+// 默认值，运行时以MotorControl_CalibrateTrackWidth测得的有效轮距为准
+#define MOTOR_TRACK_WIDTH_MM 160.0f
+
+// 名义里程：每个编码器脉冲对应的车轮行驶距离（mm）
+#define MOTOR_MM_PER_PULSE_NOMINAL (2.0f * PI * RR / PULSES_PER_REVOLUTION)
+
+// 每轮标定系数（实际里程 / 名义里程），补偿轮径误差和左右轮差异，把测得的值填到这里
+#define MOTOR_WHEEL_CAL_L 1.0f
+#define MOTOR_WHEEL_CAL_R 1.0f
+
+// 循迹传感器到车轴的前伸距离（mm，按实车测量），用于推算车轴离转角的距离
+#define MOTOR_SENSOR_LEAD_MM 80.0f
+
+// 转向状态
+typedef enum {
+    MOTOR_TURN_IDLE = 0,        // 未启动
+    MOTOR_TURN_BUSY,            // 正在转向
+    MOTOR_TURN_DONE,            // 完成（到达目标角度或循迹传感器捕获到线）
+    MOTOR_TURN_TIMEOUT          // 超时或没有航向数据
+} Motor_Turn_Status_t;
+
+// 转向阶段
+typedef enum {
+    MOTOR_TURN_PHASE_PROFILE,   // 按梯形规划加速/匀速/减速
+    MOTOR_TURN_PHASE_SETTLE,    // 规划结束，航向收敛到目标
+    MOTOR_TURN_PHASE_CAPTURE    // 到达目标角度但线不在中间，低速继续寻线
+} Motor_Turn_Phase_t;
+
+// 转向数据（MOTOR_MODE_TURN）
+typedef struct {
+    float start;                    // 起始连续航向（度）
+    float angle;                    // 要转过的角度（度，逆时针/左转为正）
+    float max_rate;                 // 最大角速度（deg/s，已按车轮能力限幅）
+    float accel;                    // 角加速度（deg/s²）
+    float rate;                     // 当前规划角速度（deg/s，沿转向方向为正）
+    float ref;                      // 当前规划角度（度，沿转向方向已转过的参考角度）
+    uint32_t ticks;                 // 已运行的控制周期数
+    uint32_t timeout_ticks;         // 超时周期数（按规划时间估算）
+    bool capture;                   // 是否用循迹传感器捕获线结束转向
+    Motor_Turn_Phase_t phase;       // 当前阶段
+    volatile Motor_Turn_Status_t status; // 转向状态
+} Motor_Turn_t;
+
+// 圆弧过弯阶段
+typedef enum {
+    MOTOR_CORNER_PHASE_ENTRY,       // 车轴还没到圆弧起点，继续循迹
+    MOTOR_CORNER_PHASE_ARC          // 按固定半径差速转弯
+} Motor_Corner_Phase_t;
+
+// 圆弧过弯数据（MOTOR_MODE_CORNER）
+typedef struct {
+    float angle;                    // 转角（度，左转为正）
+    float radius;                   // 圆弧半径（mm，车体中心）
+    q16_t speed;                    // 过弯速度（车体中心，与base_speed同单位，Q16）
+    q16_t k;                        // 内外轮速度比例 ±(轮距/2)/R（Q16，左转为正）
+    float entry;                    // 进入圆弧前还需直行的距离（mm）
+    float start_heading;            // 圆弧起点连续航向（度）
+    int32_t start_count[2];         // 阶段起点的编码器计数（没有航向时用里程差估算转角）
+    Motor_Corner_Phase_t phase;     // 当前阶段
+} Motor_Corner_t;
+
+// PID控制器编号（用于按控制器选择计算引擎）
+typedef enum {
+    MOTOR_PID_LINE = 0,         // 循迹PID
+    MOTOR_PID_YAW,              // Yaw角PID
+    MOTOR_PID_SPEED_L,          // 左轮速度PID
+    MOTOR_PID_SPEED_R,          // 右轮速度PID
+    MOTOR_PID_COUNT
+} Motor_PID_Id_t;
+
 // 电机控制结构体
 typedef struct {
     PID_Controller_t line_pid;      // 循迹PID控制器
@@ -33,12 +112,34 @@ typedef struct {
     PID_Controller_t speed_pid_L;   // 左轮速度PID控制器
     PID_Controller_t speed_pid_R;   // 右轮速度PID控制器
 
+    PID_Controller_q16_t line_pid_q16;      // 循迹PID控制器（定点）
+    PID_Controller_q16_t yaw_pid_q16;       // Yaw角PID控制器（定点）
+    PID_Controller_q16_t speed_pid_L_q16;   // 左轮速度PID控制器（定点）
+    PID_Controller_q16_t speed_pid_R_q16;   // 右轮速度PID控制器（定点）
+    PID_Engine_t pid_engine[MOTOR_PID_COUNT]; // 各PID控制器使用的计算引擎
+
     Motor_Mode_t mode;              // 当前控制模式
 
-    float base_speed;               // 基础速度
-    float target_yaw;               // 目标Yaw角
-    float left_speed_target;        // 左轮目标速度
-    float right_speed_target;       // 右轮目标速度
+    float base_speed;               // 基础速度（mm/s）
+    q16_t base_speed_q16;           // 基础速度（mm/s，Q16，设定值规划器的目标）
+    Setpoint_q16_t base_sp;         // 基础速度规划器（起步、出弯平滑加速）
+    float target_yaw;               // 目标Yaw角（±180内或连续航向）
+    float left_speed_target;        // 左轮目标速度（mm/s）
+    float right_speed_target;       // 右轮目标速度（mm/s）
+    Setpoint_q16_t wheel_sp;        // 直接速度控制的过渡进度（0 → wheel_span）
+    q16_t wheel_span;               // 过渡量（两轮目标变化量中较大者）
+    q16_t wheel_target[2];          // 直接速度控制目标（左、右，Q16）
+    q16_t wheel_from[2];            // 过渡起点（左、右）
+    q16_t wheel_scale[2];           // 各轮变化量 / wheel_span，两轮同时到达目标
+    q16_t wheel_ref[2];             // 最近一个控制周期送入速度环的左右轮目标（Q16）
+
+    Motor_Turn_t turn;              // 陀螺仪闭环转向
+    Motor_Corner_t corner;          // 圆弧过弯
+
+    float wheel_cal[2];             // 每轮标定系数（左、右）
+    float mm_per_pulse[2];          // 每轮每脉冲里程（mm）= 名义值 × 标定系数
+    q16_t mm_per_pulse_q16[2];      // 每轮每脉冲里程（Q16，速度环反馈换算用）
+    float track_width;              // 有效轮距（mm）
 
 } Motor_Control_t;
 
@@ -54,6 +155,23 @@ void MotorControl_Stop(void);
 
 // 专用控制函数
 void MotorControl_SetTargetYaw(float yaw);                              // Yaw角控制
-void MotorControl_SetSpeedTarget(float left_speed, float right_speed);  // 直接速度控制
+void MotorControl_SetSpeedTarget(float left_speed, float right_speed);  // 直接速度控制（左右轮mm/s）
+void MotorControl_SetVelocity(float v, float w);                        // 直接速度控制（车体mm/s、deg/s）
+void MotorControl_SetPIDEngine(Motor_PID_Id_t id, PID_Engine_t engine); // 选择PID计算引擎（浮点/定点）
+void MotorControl_TurnBy(float angle, float max_rate);                  // 陀螺仪闭环转过指定角度（度，左转为正）
+void MotorControl_SetTurnCapture(bool enable);                          // 转向末段是否用循迹传感器捕获线
+Motor_Turn_Status_t MotorControl_GetTurnStatus(void);                   // 查询转向状态
+float MotorControl_GetMaxTurnRate(void);                                // 原地转向能跟踪的最大角速度（deg/s）
+void MotorControl_StartCorner(float angle, float overshoot);            // 不停车圆弧过弯（转角度，传感器已越过路口的距离mm）
+bool MotorControl_IsCornering(void);                                    // 是否正在圆弧过弯
+
+// 标定与里程
+void MotorControl_SetWheelCalibration(float cal_L, float cal_R);        // 设置每轮标定系数
+void MotorControl_SetTrackWidth(float track_width);                     // 设置有效轮距（mm）
+bool MotorControl_CalibrateWheels(int32_t count_L, int32_t count_R, float distance); // 直线行驶已知距离后计算标定系数
+bool MotorControl_CalibrateTrackWidth(int32_t count_L, int32_t count_R, float angle); // 原地旋转已知角度后计算有效轮距
+float MotorControl_GetWheelSpeed(uint8_t motor_id);                     // 车轮速度（mm/s）
+float MotorControl_GetWheelDistance(uint8_t motor_id);                  // 车轮里程（mm）
+float MotorControl_GetMmPerPulse(void);                                 // 两轮平均计数的每脉冲里程（mm，已标定）
 
 #endif /* MOTOR_CONTROL_H_ */
\ No newline at end of file
@@ -104,4 +104,207 @@ void PID_Reset(PID_Controller_t *pid)
     pid->prev_error = 0.0f;
     pid->integral = 0.0f;
     pid->output = 0.0f;
-}
\ No newline at end of file
+}
+
+/* ======================== Q16.16定点PID引擎 ======================== */
+
+/**
+ * @brief Q16.16定点乘法（64位中间结果，向负无穷截断）
+ */
+q16_t q16_mul(q16_t a, q16_t b)
+{
+    return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+/**
+ * @brief 将64位中间结果饱和到Q16.16范围
+ */
+static q16_t q16_sat(int64_t x)
+{
+    if (x > INT32_MAX) return INT32_MAX;
+    if (x < INT32_MIN) return INT32_MIN;
+    return (q16_t)x;
+}
+
+/**
+ * @brief 初始化定点PID控制器
+ * @param pid 指向定点PID控制器结构体的指针
+ * @param Kp 比例增益
+ * @param Ki 积分增益
+ * @param Kd 微分增益
+ * @param integral_limit 积分限幅
+ * @param output_limit 输出限幅
+ * @note 浮点参数只在初始化时转换一次，PID_Q16_Calculate中不再有浮点运算
+ */
+void PID_Q16_Init(PID_Controller_q16_t *pid, float Kp, float Ki, float Kd, float integral_limit, float output_limit)
+{
+    pid->Kp = Q16_FROM_FLOAT(Kp);
+    pid->Ki = Q16_FROM_FLOAT(Ki);
+    pid->Kd = Q16_FROM_FLOAT(Kd);
+    pid->integral_limit = Q16_FROM_FLOAT(integral_limit);
+    pid->output_limit = Q16_FROM_FLOAT(output_limit);
+    PID_Q16_Reset(pid);
+}
+
+/**
+ * @brief 设置定点PID目标值
+ * @param pid 指向定点PID控制器结构体的指针
+ * @param target 目标值（Q16.16）
+ */
+void PID_Q16_SetTarget(PID_Controller_q16_t *pid, q16_t target)
+{
+    pid->target = target;
+}
+
+/**
+ * @brief 计算定点PID输出
+ * @param pid 指向定点PID控制器结构体的指针
+ * @param actual 实际值（Q16.16）
+ * @return PID输出值（Q16.16）
+ * @note 与PID_Calculate的积分限幅和抗积分饱和逻辑完全一致
+ */
+q16_t PID_Q16_Calculate(PID_Controller_q16_t *pid, q16_t actual)
+{
+    pid->actual = actual;
+    pid->error = q16_sat((int64_t)pid->target - pid->actual);
+
+    // 积分项计算和积分限幅
+    q16_t integral_temp = q16_sat((int64_t)pid->integral + pid->error);
+    if (integral_temp > pid->integral_limit) {
+        integral_temp = pid->integral_limit;
+    } else if (integral_temp < -pid->integral_limit) {
+        integral_temp = -pid->integral_limit;
+    }
+
+    q16_t output_p = q16_mul(pid->Kp, pid->error);
+    q16_t output_i = q16_mul(pid->Ki, integral_temp);
+    q16_t output_d = q16_mul(pid->Kd, q16_sat((int64_t)pid->error - pid->last_error));
+
+    int64_t output_total = (int64_t)output_p + output_i + output_d;
+
+    // 只有在输出未饱和时才更新积分项，或者误差与积分输出同方向时才更新
+    if ((output_total >= -pid->output_limit && output_total <= pid->output_limit) ||
+        (pid->error > 0 && output_i > 0) || (pid->error < 0 && output_i < 0)) {
+        pid->integral = integral_temp;
+    }
+
+    // PID计算
+    int64_t output = (int64_t)output_p + q16_mul(pid->Ki, pid->integral) + output_d;
+
+    // 输出限幅
+    if (output > pid->output_limit) {
+        output = pid->output_limit;
+    } else if (output < -pid->output_limit) {
+        output = -pid->output_limit;
+    }
+    pid->output = (q16_t)output;
+
+    pid->last_error = pid->error;
+
+    return pid->output;
+}
+
+/**
+ * @brief 重置定点PID控制器状态
+ * @param pid 指向定点PID控制器结构体的指针
+ */
+void PID_Q16_Reset(PID_Controller_q16_t *pid)
+{
+    pid->target = 0;
+    pid->actual = 0;
+    pid->error = 0;
+    pid->last_error = 0;
+    pid->integral = 0;
+    pid->output = 0;
+}
+
+/* ======================== 定点设定值规划器 ======================== */
+
+/**
+ * @brief 初始化设定值规划器
+ * @param sp 指向规划器的指针
+ * @param accel 加速度限制（设定值单位/s）
+ * @param jerk 加加速度限制（设定值单位/s²），0表示梯形规划
+ * @param period_s 调用Setpoint_Step的周期（s）
+ */
+void Setpoint_Init(Setpoint_q16_t *sp, float accel, float jerk, float period_s)
+{
+    sp->rate_max = Q16_FROM_FLOAT(accel * period_s);
+    sp->jerk = Q16_FROM_FLOAT(jerk * period_s * period_s);
+    if (sp->rate_max <= 0) {
+        sp->rate_max = 1;
+    }
+    if (sp->jerk < 0) {
+        sp->jerk = 0;
+    }
+    Setpoint_Reset(sp, 0);
+}
+
+/**
+ * @brief 把设定值直接置为指定值（停车、切换模式时使用）
+ */
+void Setpoint_Reset(Setpoint_q16_t *sp, q16_t value)
+{
+    sp->value = value;
+    sp->rate = 0;
+}
+
+/**
+ * @brief 向目标值推进一个周期
+ * @param sp 指向规划器的指针
+ * @param target 目标值（Q16.16，可以随时改变）
+ * @return 本周期的设定值
+ * @note S形规划：每周期变化率按jerk加大、保持或减小三选一，保证随时都还能在目标处把变化率减到0；
+ *       变化率背离目标（目标中途反向）时总是朝目标方向加大。
+ *       全程整数运算（每周期至多两次64位乘法），可在控制中断中调用
+ */
+q16_t Setpoint_Step(Setpoint_q16_t *sp, q16_t target)
+{
+    int32_t err = target - sp->value;
+    int32_t dir = (err > 0) ? 1 : -1;
+    int32_t a = sp->rate;
+    int32_t j = sp->jerk;
+
+    if (err == 0) {
+        sp->rate = 0;
+        return sp->value;
+    }
+
+    if (j == 0) {
+        // 梯形：变化率直接取上限
+        a = dir * sp->rate_max;
+    } else {
+        // 沿目标方向的变化率和剩余量
+        int32_t v = a * dir;
+        int32_t rem = err * dir;
+        int32_t up = v + j;
+
+        // 以变化率v走完这一周期后，再按jerk减到0还要走 v(v-j)/2j：
+        // 加大后仍来得及停住就加大，保持来得及就保持，否则减小
+        if (up > sp->rate_max) {
+            up = sp->rate_max;
+        }
+        if (v <= 0 || (int64_t)up * (up - j) <= 2 * (int64_t)j * (rem - up)) {
+            v = up;
+        } else if ((int64_t)v * (v - j) <= 2 * (int64_t)j * (rem - v)) {
+            // 保持
+        } else {
+            v -= j;
+            if (v < j) {
+                v = j;
+            }
+        }
+        a = v * dir;
+    }
+
+    // 本周期就能到达（或越过）目标：直接到目标
+    if ((dir > 0 && a >= err) || (dir < 0 && a <= err)) {
+        sp->value = target;
+        sp->rate = 0;
+        return target;
+    }
+
+    sp->value += a;
+    sp->rate = a;
+    return sp->value;
+}
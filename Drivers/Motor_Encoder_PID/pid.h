@@ -30,9 +30,64 @@ typedef struct {
 
 } PID_Controller_t;
 
+// PID计算引擎选择（M0+无FPU，定点引擎可大幅减少控制中断耗时）
+typedef enum {
+    PID_ENGINE_FLOAT = 0,       // 单精度浮点（软件浮点库）
+    PID_ENGINE_Q16              // Q16.16定点
+} PID_Engine_t;
+
+// Q16.16定点数：高16位整数，低16位小数，表示范围约 ±32767.99998
+typedef int32_t q16_t;
+
+#define Q16_ONE             ((q16_t)0x00010000)
+#define Q16_FROM_INT(x)     ((q16_t)((int32_t)(x) * Q16_ONE))
+#define Q16_FROM_FLOAT(x)   ((q16_t)((x) * 65536.0f + (((x) >= 0.0f) ? 0.5f : -0.5f)))
+#define Q16_TO_FLOAT(x)     ((float)(x) * (1.0f / 65536.0f))
+#define Q16_TO_INT(x)       ((int32_t)(x) >> 16)
+
+// 定点PID控制器结构体（与PID_Controller_t字段一一对应，抗积分饱和逻辑相同）
+typedef struct {
+    q16_t Kp;                   // 比例增益
+    q16_t Ki;                   // 积分增益
+    q16_t Kd;                   // 微分增益
+
+    q16_t target;               // 目标值
+    q16_t actual;               // 实际值
+
+    q16_t error;                // 当前误差
+    q16_t last_error;           // 上一次误差
+    q16_t integral;             // 积分累计值
+
+    q16_t output;               // PID输出
+
+    q16_t integral_limit;       // 积分限幅
+    q16_t output_limit;         // 输出限幅
+
+} PID_Controller_q16_t;
+
 void PID_Init(PID_Controller_t *pid, float Kp, float Ki, float Kd, float integral_limit, float output_limit);
 void PID_SetTarget(PID_Controller_t *pid, float target);
 float PID_Calculate(PID_Controller_t *pid, float actual);
 void PID_Reset(PID_Controller_t *pid);
 
+// 定点PID接口（参数在初始化时由浮点转换，运行时全程整数运算）
+void PID_Q16_Init(PID_Controller_q16_t *pid, float Kp, float Ki, float Kd, float integral_limit, float output_limit);
+void PID_Q16_SetTarget(PID_Controller_q16_t *pid, q16_t target);
+q16_t PID_Q16_Calculate(PID_Controller_q16_t *pid, q16_t actual);
+void PID_Q16_Reset(PID_Controller_q16_t *pid);
+
+// 定点设定值规划器：目标值阶跃时按加速度、加加速度限制平滑过渡
+// jerk为0时为梯形（变化率直接到上限），否则为S形（变化率按jerk线性增减）
+typedef struct {
+    q16_t value;                // 当前设定值
+    q16_t rate;                 // 当前变化率（每周期变化量，带符号）
+    q16_t rate_max;             // 变化率上限（加速度 × 周期）
+    q16_t jerk;                 // 每周期变化率的最大改变量（加加速度 × 周期²），0表示不限制
+} Setpoint_q16_t;
+
+void Setpoint_Init(Setpoint_q16_t *sp, float accel, float jerk, float period_s);
+void Setpoint_Reset(Setpoint_q16_t *sp, q16_t value);
+q16_t Setpoint_Step(Setpoint_q16_t *sp, q16_t target);
+q16_t q16_mul(q16_t a, q16_t b);
+
 #endif /* PID_H_ */
\ No newline at end of file
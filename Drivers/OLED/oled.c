@@ -0,0 +1,536 @@
+/*
+ * oled.c
+ *
+ *  SSD1306 OLED 绘制核心，与传输方式无关
+ */
+#include "oled.h"
+#include "oledfont.h"
+#include "clock.h"
+#include <string.h>
+
+#if OLED_AUTO_REFRESH == 2
+#define OLED_AUTO_FLUSH() ((void)OLED_FlushAsync(0))
+#elif OLED_AUTO_REFRESH == 1
+#define OLED_AUTO_FLUSH() OLED_Refresh()
+#else
+#define OLED_AUTO_FLUSH() ((void)0)
+#endif
+
+//OLED的显存
+//存放格式如下.
+//[0]0 1 2 3 ... 127	
+//[1]0 1 2 3 ... 127	
+//[2]0 1 2 3 ... 127	
+//[3]0 1 2 3 ... 127	
+//[4]0 1 2 3 ... 127	
+//[5]0 1 2 3 ... 127	
+//[6]0 1 2 3 ... 127	
+//[7]0 1 2 3 ... 127
+static uint8_t OLED_GRAM[OLED_PAGES][OLED_WIDTH];
+
+//每页的脏列范围[dirty_min, dirty_max]，dirty_min > dirty_max 表示该页无改动
+static uint8_t dirty_min[OLED_PAGES];
+static uint8_t dirty_max[OLED_PAGES];
+
+//异步刷新状态（传输层完成中断逐页推进）
+static volatile bool flush_busy = false;
+#if OLED_TRANSPORT_ASYNC
+//正在发送的页数据副本：DMA/FIFO只读这里，主循环继续改写显存不会撕裂正在发送的页
+static uint8_t flush_buf[OLED_WIDTH];
+//正在发送的页和列范围（发送失败时重新标脏）
+static uint8_t flush_page, flush_x0, flush_x1;
+#endif
+static void (*flush_done)(void) = 0;
+
+//SSD1306初始化命令序列
+static const uint8_t OLED_InitCmds[] = {
+    0xAE,//--turn off oled panel
+    0x00,//---set low column address
+    0x10,//---set high column address
+    0x40,//--set start line address  Set Mapping RAM Display Start Line (0x00~0x3F)
+    0x81,//--set contrast control register
+    0xCF,// Set SEG Output Current Brightness
+    0xA1,//--Set SEG/Column Mapping     0xa0左右反置 0xa1正常
+    0xC8,//Set COM/Row Scan Direction   0xc0上下反置 0xc8正常
+    0xA6,//--set normal display
+    0xA8,//--set multiplex ratio(1 to 64)
+    0x3f,//--1/64 duty
+    0xD3,//-set display offset	Shift Mapping RAM Counter (0x00~0x3F)
+    0x00,//-not offset
+    0xd5,//--set display clock divide ratio/oscillator frequency
+    0x80,//--set divide ratio, Set Clock as 100 Frames/Sec
+    0xD9,//--set pre-charge period
+    0xF1,//Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
+    0xDA,//--set com pins hardware configuration
+    0x12,
+    0xDB,//--set vcomh
+    0x40,//Set VCOM Deselect Level
+    0x20,//-Set Page Addressing Mode (0x00/0x01/0x02)
+    0x02,//
+    0x8D,//--set Charge Pump enable/disable
+    0x14,//--set(0x10) disable
+    0xA4,// Disable Entire Display On (0xa4/0xa5)
+    0xA6,// Disable Inverse Display On (0xa6/a7) 
+};
+
+void delay_ms(uint32_t ms)
+{
+    mspm0_delay_ms(ms);
+}
+
+//反显函数
+void OLED_ColorTurn(uint8_t i)
+{
+    if(i==0)
+    {
+        OLED_WR_Byte(0xA6,OLED_CMD);//正常显示
+    }
+    if(i==1)
+    {
+        OLED_WR_Byte(0xA7,OLED_CMD);//反色显示
+    }
+}
+
+//屏幕旋转180度
+void OLED_DisplayTurn(uint8_t i)
+{
+if(i==0)
+    {
+        OLED_WR_Byte(0xC8,OLED_CMD);//正常显示
+        OLED_WR_Byte(0xA1,OLED_CMD);
+    }
+    if(i==1)
+    {
+        OLED_WR_Byte(0xC0,OLED_CMD);//反转显示
+        OLED_WR_Byte(0xA0,OLED_CMD);
+    }
+}
+
+//等待异步刷新结束，不与DMA抢总线
+//等待期间由传输层检查超时：总线卡死时传输被中止并以出错结束刷新，不会死等
+static void OLED_WaitIdle(void)
+{
+#if OLED_TRANSPORT_ASYNC
+    while (flush_busy) OLED_Transport_Poll();
+#endif
+}
+
+//发送一个字节
+//向SSD1306写入一个字节。
+//mode:数据/命令标志 0,表示命令;1,表示数据;
+void OLED_WR_Byte(uint8_t dat,uint8_t mode)
+{
+    OLED_WaitIdle();
+    OLED_Transport_Write(&dat, 1, mode);
+}
+
+//写显存中的一个字节，内容有变化时才标记为脏
+//先写显存再标脏：完成中断在两步之间取走本页时，随后的标脏会让这个字节在下一轮补发
+//脏范围的读改写在关中断下进行，避免与完成中断清脏交错成dirty_min=128、dirty_max=x而丢失改动
+static void OLED_GRAM_Write(uint8_t x, uint8_t page, uint8_t dat)
+{
+    uint32_t primask;
+
+    if(x >= OLED_WIDTH || page >= OLED_PAGES) return;
+    if(OLED_GRAM[page][x] == dat) return;
+    OLED_GRAM[page][x] = dat;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(x < dirty_min[page]) dirty_min[page] = x;
+    if(x > dirty_max[page]) dirty_max[page] = x;
+    __set_PRIMASK(primask);
+}
+
+//整屏标记为脏，下次刷新整屏重发（屏幕内容未知时使用，如初始化、屏幕掉电重连）
+void OLED_Invalidate(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(dirty_min, 0, sizeof(dirty_min));
+    memset(dirty_max, OLED_WIDTH - 1, sizeof(dirty_max));
+    __set_PRIMASK(primask);
+}
+
+//把显存中改动过的区域刷新到屏幕
+//每个脏页只发一次定位命令和一次连续的数据
+void OLED_Refresh(void)
+{
+    uint8_t page;
+    OLED_WaitIdle();
+    for(page = 0; page < OLED_PAGES; page++)
+    {
+        if(dirty_min[page] > dirty_max[page]) continue;
+        OLED_Set_Pos(dirty_min[page], page);
+        OLED_Transport_Write(&OLED_GRAM[page][dirty_min[page]], dirty_max[page] - dirty_min[page] + 1, OLED_DATA);
+        dirty_min[page] = OLED_WIDTH;
+        dirty_max[page] = 0;
+    }
+}
+
+#if OLED_TRANSPORT_ASYNC
+//把[x0, x1]重新标为脏（发送失败的页，下一次刷新补发）
+static void OLED_MarkDirty(uint8_t page, uint8_t x0, uint8_t x1)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(x0 < dirty_min[page]) dirty_min[page] = x0;
+    if(x1 > dirty_max[page]) dirty_max[page] = x1;
+    __set_PRIMASK(primask);
+}
+
+//结束异步刷新（全部发完或出错）
+static void OLED_FlushEnd(void)
+{
+    OLED_Transport_AsyncEnd();
+    flush_busy = false;
+    if(flush_done) flush_done();
+}
+
+//启动下一个脏页的异步发送，没有脏页或传输层拒绝时返回false
+//取脏范围、清脏标记和拷贝页数据在关中断下一次完成，发送的是拷贝出来的一致快照
+static bool OLED_StartNextPage(void)
+{
+    uint8_t page, x0;
+    uint16_t len;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for(page = 0; page < OLED_PAGES; page++)
+    {
+        if(dirty_min[page] <= dirty_max[page]) break;
+    }
+    if(page == OLED_PAGES)
+    {
+        __set_PRIMASK(primask);
+        return false;
+    }
+
+    //先清脏标记再发送：传输期间主循环再修改的内容会重新标脏，下一轮补发
+    x0 = dirty_min[page];
+    len = dirty_max[page] - x0 + 1;
+    dirty_min[page] = OLED_WIDTH;
+    dirty_max[page] = 0;
+    memcpy(flush_buf, &OLED_GRAM[page][x0], len);
+    __set_PRIMASK(primask);
+
+    flush_page = page;
+    flush_x0 = x0;
+    flush_x1 = x0 + len - 1;
+    if(!OLED_Transport_PageAsync(page, x0, flush_buf, len))
+    {
+        OLED_MarkDirty(page, flush_x0, flush_x1);
+        return false;
+    }
+    return true;
+}
+
+//传输层完成中断：当前页发完，继续下一页或结束
+void OLED_TxDone_IRQHandler(void)
+{
+    if(!flush_busy) return;
+    if(!OLED_StartNextPage()) OLED_FlushEnd();
+}
+
+//传输层出错/超时中止：当前页重新标脏，结束本次刷新（下一次刷新补发）
+void OLED_TxError_IRQHandler(void)
+{
+    if(!flush_busy) return;
+    OLED_MarkDirty(flush_page, flush_x0, flush_x1);
+    OLED_FlushEnd();
+}
+#endif
+
+//异步刷新：把脏区域交给传输层DMA发送，立即返回
+//on_done:全部发送完成（或出错中止）后在中断中调用（可为NULL）
+//返回false表示上一次刷新还在进行（进行中的刷新会把新的脏区域一并发出）
+//传输层不支持DMA时退化为同步刷新
+bool OLED_FlushAsync(void (*on_done)(void))
+{
+#if OLED_TRANSPORT_ASYNC
+    if(flush_busy)
+    {
+        //顺便检查超时，只调用异步刷新的主循环也能从总线卡死中恢复
+        OLED_Transport_Poll();
+        return false;
+    }
+
+    flush_done = on_done;
+    flush_busy = true;
+    if(!OLED_StartNextPage())
+    {
+        flush_busy = false;
+        if(on_done) on_done();
+        return true;
+    }
+    OLED_Transport_AsyncBegin();
+    return true;
+#else
+    OLED_Refresh();
+    if(on_done) on_done();
+    return true;
+#endif
+}
+
+//异步刷新是否正在进行
+bool OLED_IsBusy(void)
+{
+    return flush_busy;
+}
+
+//坐标设置
+void OLED_Set_Pos(uint8_t x, uint8_t y) 
+{ 
+    uint8_t cmd[3];
+    cmd[0] = 0xb0+y;
+    cmd[1] = ((x&0xf0)>>4)|0x10;
+    cmd[2] = (x&0x0f);
+    OLED_WaitIdle();
+    OLED_Transport_Write(cmd, 3, OLED_CMD);
+}
+
+//开启OLED显示    
+void OLED_Display_On(void)
+{
+    OLED_WR_Byte(0X8D,OLED_CMD);  //SET DCDC命令
+    OLED_WR_Byte(0X14,OLED_CMD);  //DCDC ON
+    OLED_WR_Byte(0XAF,OLED_CMD);  //DISPLAY ON
+}
+
+//关闭OLED显示     
+void OLED_Display_Off(void)
+{
+    OLED_WR_Byte(0X8D,OLED_CMD);  //SET DCDC命令
+    OLED_WR_Byte(0X10,OLED_CMD);  //DCDC OFF
+    OLED_WR_Byte(0XAE,OLED_CMD);  //DISPLAY OFF
+}
+	 
+//清屏函数,清完屏,整个屏幕是黑色的!和没点亮一样!!!	  
+void OLED_Clear(void)  
+{  
+    uint8_t i,n;		    
+    for(i=0;i<OLED_PAGES;i++)  
+    {  
+        for(n=0;n<OLED_WIDTH;n++)OLED_GRAM_Write(n,i,0); 
+    }
+    OLED_AUTO_FLUSH(); //更新显示
+}
+
+//在显存中绘制一个字符（不刷新）
+static void OLED_DrawChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey)
+{      	
+    uint8_t c=0,sizex=sizey/2;
+    uint16_t i=0,size1;
+    if(sizey==8)size1=6;
+    else size1=(sizey/8+((sizey%8)?1:0))*(sizey/2);
+    c=chr-' ';//得到偏移后的值
+    for(i=0;i<size1;i++)
+    {
+        if(sizey==8) OLED_GRAM_Write(x+i,y,asc2_0806[c][i]);//6X8字号
+        else if(sizey==16) OLED_GRAM_Write(x+i%sizex,y+i/sizex,asc2_1608[c][i]);//8x16字号
+        //		else if(sizey==xx) OLED_GRAM_Write(x+i%sizex,y+i/sizex,asc2_xxxx[c][i]);//用户添加字号
+        else return;
+    }
+}
+
+//在指定位置显示一个字符,包括部分字符
+//x:0~127
+//y:0~63				 
+//sizey:选择字体 6x8  8x16
+void OLED_ShowChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey)
+{      	
+    OLED_DrawChar(x,y,chr,sizey);
+    OLED_AUTO_FLUSH();
+}
+
+//字符宽度（6x8字号按6列排列，与原ShowNum/ShowString一致）
+#define OLED_CHAR_W(sizey) ((sizey)==8?6:(sizey)/2)
+
+//10的幂，数字转换用逐位相减代替除法（M0+没有硬件除法器）
+static const uint32_t OLED_Pow10[10] = {
+    1u, 10u, 100u, 1000u, 10000u,
+    100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+//无符号数转十进制数字串，不补结束符
+//min_digits:至少输出的位数（不足时高位补0，最大10）
+//返回输出的位数。每位最多减9次，最坏约90次减法，耗时有上界
+static uint8_t OLED_FormatU32(char *buf, uint32_t num, uint8_t min_digits)
+{
+    uint8_t i = 10, n = 0;
+    char d;
+    while(i--)
+    {
+        d = '0';
+        while(num >= OLED_Pow10[i])
+        {
+            num -= OLED_Pow10[i];
+            d++;
+        }
+        if(n || d != '0' || i < min_digits) buf[n++] = d;
+    }
+    return n;
+}
+
+//在显存中绘制len个字符，不足width个字符时左侧补空格（右对齐），返回下一个字符的x坐标
+static uint8_t OLED_DrawField(uint8_t x,uint8_t y,const char *buf,uint8_t len,uint8_t width,uint8_t sizey)
+{
+    uint8_t i;
+    for(i = len; i < width; i++)
+    {
+        OLED_DrawChar(x,y,' ',sizey);
+        x += OLED_CHAR_W(sizey);
+    }
+    for(i = 0; i < len; i++)
+    {
+        OLED_DrawChar(x,y,buf[i],sizey);
+        x += OLED_CHAR_W(sizey);
+    }
+    return x;
+}
+
+//显示数字
+//x,y :起点坐标
+//num:要显示的数字
+//len :数字的位数（显示低len位，高位的0显示为空格）
+//sizey:字体大小		  
+void OLED_ShowNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len,uint8_t sizey)
+{         	
+    char buf[10];
+    uint8_t t;
+    if(len > 10) len = 10;
+    OLED_FormatU32(buf, num, 10);
+    for(t = 10 - len; t < 9 && buf[t] == '0'; t++)
+    {
+        buf[t] = ' ';
+    }
+    OLED_DrawField(x,y,&buf[10 - len],len,0,sizey);
+    OLED_AUTO_FLUSH();
+}
+
+//显示有符号整数（不经过sprintf，不占堆）
+//width:最少占用的字符数，不足时左侧补空格，0表示不补
+//返回下一个字符的x坐标，便于和OLED_ShowString拼接
+uint8_t OLED_ShowInt(uint8_t x,uint8_t y,int32_t num,uint8_t width,uint8_t sizey)
+{
+    char buf[11];
+    uint8_t n = 0;
+    uint32_t u = (uint32_t)num;
+    if(num < 0)
+    {
+        buf[n++] = '-';
+        u = 0u - u;
+    }
+    n += OLED_FormatU32(&buf[n], u, 1);
+    x = OLED_DrawField(x,y,buf,n,width,sizey);
+    OLED_AUTO_FLUSH();
+    return x;
+}
+
+//显示定点小数
+//num:放大10^frac倍后的整数，如num=-1234,frac=2显示"-12.34"
+//frac:小数位数（0~9）
+//width:最少占用的字符数，不足时左侧补空格，0表示不补
+//返回下一个字符的x坐标
+uint8_t OLED_ShowFixed(uint8_t x,uint8_t y,int32_t num,uint8_t frac,uint8_t width,uint8_t sizey)
+{
+    char buf[12];
+    uint8_t n = 0, digits, i;
+    uint32_t u = (uint32_t)num;
+    if(frac > 9) frac = 9;
+    if(num < 0)
+    {
+        buf[n++] = '-';
+        u = 0u - u;
+    }
+    digits = OLED_FormatU32(&buf[n], u, frac + 1);
+    n += digits;
+    if(frac)
+    {
+        for(i = 0; i < frac; i++)
+        {
+            buf[n - i] = buf[n - i - 1];
+        }
+        buf[n - frac] = '.';
+        n++;
+    }
+    x = OLED_DrawField(x,y,buf,n,width,sizey);
+    OLED_AUTO_FLUSH();
+    return x;
+}
+
+//显示位图串，bit0在最左边，置位显示'1'，否则显示'0'（如循迹传感器状态）
+//count:显示的位数（最多32）
+//返回下一个字符的x坐标
+uint8_t OLED_ShowBits(uint8_t x,uint8_t y,uint32_t bits,uint8_t count,uint8_t sizey)
+{
+    uint8_t i;
+    if(count > 32) count = 32;
+    for(i = 0; i < count; i++)
+    {
+        OLED_DrawChar(x,y,(bits & 1u) ? '1' : '0',sizey);
+        bits >>= 1;
+        x += OLED_CHAR_W(sizey);
+    }
+    OLED_AUTO_FLUSH();
+    return x;
+}
+
+//显示一个字符号串
+//返回下一个字符的x坐标
+uint8_t OLED_ShowString(uint8_t x,uint8_t y,uint8_t *chr,uint8_t sizey)
+{
+    uint8_t j=0;
+    while (chr[j]!='\0')
+    {		
+        OLED_DrawChar(x,y,chr[j++],sizey);
+        x+=OLED_CHAR_W(sizey);
+    }
+    OLED_AUTO_FLUSH();
+    return x;
+}
+
+//显示汉字
+void OLED_ShowChinese(uint8_t x,uint8_t y,uint8_t no,uint8_t sizey)
+{
+    uint16_t i,size1=(sizey/8+((sizey%8)?1:0))*sizey;
+    for(i=0;i<size1;i++)
+    {
+        if(sizey==16) OLED_GRAM_Write(x+i%sizey,y+i/sizey,Hzk[no][i]);//16x16字号
+        //		else if(sizey==xx) OLED_GRAM_Write(x+i%sizey,y+i/sizey,xxx[c][i]);//用户添加字号
+        else return;
+    }				
+    OLED_AUTO_FLUSH();
+}
+
+//显示图片
+//x,y显示坐标
+//sizex,sizey,图片长宽
+//BMP：要显示的图片
+void OLED_DrawBMP(uint8_t x,uint8_t y,uint8_t sizex, uint8_t sizey,uint8_t BMP[])
+{ 	
+    uint16_t j=0;
+    uint8_t i,m;
+    sizey=sizey/8+((sizey%8)?1:0);
+    for(i=0;i<sizey;i++)
+    {
+        for(m=0;m<sizex;m++)
+        {      
+            OLED_GRAM_Write(x+m,i+y,BMP[j++]);	    	
+        }
+    }
+    OLED_AUTO_FLUSH();
+}
+
+//初始化SSD1306					    
+void OLED_Init(void)
+{
+    OLED_Transport_Init();
+
+    OLED_Transport_Write(OLED_InitCmds, sizeof(OLED_InitCmds), OLED_CMD);
+    memset(OLED_GRAM, 0, sizeof(OLED_GRAM));
+    OLED_Invalidate();//屏幕原有内容未知，整屏写一次
+    OLED_Refresh();
+    OLED_WR_Byte(0xAF,OLED_CMD); /*display ON*/ 
+}
@@ -0,0 +1,100 @@
+/*
+ * oled.h
+ *
+ *  SSD1306 OLED 绘制核心（显存、文字、数字、图片、刷新）
+ *
+ *  传输层在编译期选择，绘制核心直接调用被选中传输层的OLED_Transport_*函数，没有函数指针开销：
+ *    OLED_TRANSPORT_HW_I2C  硬件I2C（Drivers/OLED_Hardware_I2C，默认）
+ *    OLED_TRANSPORT_HW_SPI  硬件SPI（Drivers/OLED_Hardware_SPI）
+ *    OLED_TRANSPORT_SW_I2C  软件I2C（Drivers/OLED_Software_I2C）
+ *    OLED_TRANSPORT_SW_SPI  软件SPI（Drivers/OLED_Software_SPI）
+ *  各传输层需要的SysConfig配置见对应的头文件。未选中的传输层源文件编译为空。
+ */
+
+#ifndef __OLED_H
+#define __OLED_H
+
+#include "ti_msp_dl_config.h"
+#include <stdbool.h>
+
+#define OLED_TRANSPORT_HW_I2C  0
+#define OLED_TRANSPORT_HW_SPI  1
+#define OLED_TRANSPORT_SW_I2C  2
+#define OLED_TRANSPORT_SW_SPI  3
+
+#ifndef OLED_TRANSPORT
+#define OLED_TRANSPORT OLED_TRANSPORT_HW_I2C
+#endif
+
+#define OLED_CMD  0	//写命令
+#define OLED_DATA 1	//写数据
+
+#define OLED_WIDTH  128	//屏幕宽度（列）
+#define OLED_PAGES  8	//屏幕页数（每页8行）
+
+#if OLED_TRANSPORT == OLED_TRANSPORT_HW_I2C
+#include "oled_hardware_i2c.h"
+#elif OLED_TRANSPORT == OLED_TRANSPORT_HW_SPI
+#include "oled_hardware_spi.h"
+#elif OLED_TRANSPORT == OLED_TRANSPORT_SW_I2C
+#include "oled_software_i2c.h"
+#elif OLED_TRANSPORT == OLED_TRANSPORT_SW_SPI
+#include "oled_software_spi.h"
+#else
+#error "Unknown OLED_TRANSPORT"
+#endif
+
+//传输层是否支持DMA异步发送（由传输层头文件定义）
+#ifndef OLED_TRANSPORT_ASYNC
+#define OLED_TRANSPORT_ASYNC 0
+#endif
+
+//绘制函数只修改显存，改动区域由OLED_Refresh/OLED_FlushAsync刷新到屏幕
+//OLED_AUTO_REFRESH:
+//  0 不自动刷新，由调用者在一帧画完后调用OLED_Refresh或OLED_FlushAsync
+//  1 每个显示函数结束后同步刷新（与原来的立即显示行为一致）
+//  2 每个显示函数结束后启动异步刷新，不阻塞调用者（传输层支持DMA时默认）
+#ifndef OLED_AUTO_REFRESH
+#if OLED_TRANSPORT_ASYNC
+#define OLED_AUTO_REFRESH 2
+#else
+#define OLED_AUTO_REFRESH 1
+#endif
+#endif
+
+//传输层接口（每个传输层实现一套）
+void OLED_Transport_Init(void);                                             //复位/总线准备
+void OLED_Transport_Write(const uint8_t *dat, uint16_t len, uint8_t mode);  //同步发送一段命令或数据
+#if OLED_TRANSPORT_ASYNC
+bool OLED_Transport_PageAsync(uint8_t page, uint8_t x0, const uint8_t *dat, uint16_t len); //启动一页DMA发送（定位+数据），失败返回false
+void OLED_Transport_AsyncBegin(void);                                      //开启完成中断
+void OLED_Transport_AsyncEnd(void);                                        //关闭完成中断
+void OLED_Transport_Poll(void);                                            //主循环等待刷新时调用，检查传输超时
+#endif
+
+//OLED控制用函数
+void delay_ms(uint32_t ms);
+void OLED_ColorTurn(uint8_t i);
+void OLED_DisplayTurn(uint8_t i);
+void OLED_WR_Byte(uint8_t dat,uint8_t cmd);
+void OLED_Set_Pos(uint8_t x, uint8_t y);
+void OLED_Display_On(void);
+void OLED_Display_Off(void);
+void OLED_Clear(void);
+void OLED_Invalidate(void);
+void OLED_Refresh(void);
+bool OLED_FlushAsync(void (*on_done)(void));
+bool OLED_IsBusy(void);
+void OLED_TxDone_IRQHandler(void);
+void OLED_TxError_IRQHandler(void);
+void OLED_ShowChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey);
+void OLED_ShowNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len,uint8_t sizey);
+uint8_t OLED_ShowString(uint8_t x,uint8_t y,uint8_t *chr,uint8_t sizey);
+uint8_t OLED_ShowInt(uint8_t x,uint8_t y,int32_t num,uint8_t width,uint8_t sizey);
+uint8_t OLED_ShowFixed(uint8_t x,uint8_t y,int32_t num,uint8_t frac,uint8_t width,uint8_t sizey);
+uint8_t OLED_ShowBits(uint8_t x,uint8_t y,uint32_t bits,uint8_t count,uint8_t sizey);
+void OLED_ShowChinese(uint8_t x,uint8_t y,uint8_t no,uint8_t sizey);
+void OLED_DrawBMP(uint8_t x,uint8_t y,uint8_t sizex, uint8_t sizey,uint8_t BMP[]);
+void OLED_Init(void);
+
+#endif /* #ifndef __OLED_H */
@@ -1,308 +1,82 @@
-#include "oled_hardware_i2c.h"
-#include "oledfont.h"
-#include "clock.h"
-
-#define I2C_TIMEOUT_MS  (10)
-
-//OLED的显存
-//存放格式如下.
-//[0]0 1 2 3 ... 127	
-//[1]0 1 2 3 ... 127	
-//[2]0 1 2 3 ... 127	
-//[3]0 1 2 3 ... 127	
-//[4]0 1 2 3 ... 127	
-//[5]0 1 2 3 ... 127	
-//[6]0 1 2 3 ... 127	
-//[7]0 1 2 3 ... 127
+#include "oled.h"
 
-void delay_ms(uint32_t ms)
-{
-    mspm0_delay_ms(ms);
-}
+#if OLED_TRANSPORT == OLED_TRANSPORT_HW_I2C
 
-static int mspm0_i2c_disable(void)
-{
-    DL_I2C_reset(I2C_OLED_INST);
-    DL_GPIO_initDigitalOutput(GPIO_I2C_OLED_IOMUX_SCL);
-    DL_GPIO_initDigitalInputFeatures(GPIO_I2C_OLED_IOMUX_SDA,
-		 DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_NONE,
-		 DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_clearPins(GPIO_I2C_OLED_SCL_PORT, GPIO_I2C_OLED_SCL_PIN);
-    DL_GPIO_enableOutput(GPIO_I2C_OLED_SCL_PORT, GPIO_I2C_OLED_SCL_PIN);
-    return 0;
-}
-
-static int mspm0_i2c_enable(void)
-{
-    DL_I2C_reset(I2C_OLED_INST);
-    DL_GPIO_initPeripheralInputFunctionFeatures(GPIO_I2C_OLED_IOMUX_SDA,
-        GPIO_I2C_OLED_IOMUX_SDA_FUNC, DL_GPIO_INVERSION_DISABLE,
-        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
-        DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_initPeripheralInputFunctionFeatures(GPIO_I2C_OLED_IOMUX_SCL,
-        GPIO_I2C_OLED_IOMUX_SCL_FUNC, DL_GPIO_INVERSION_DISABLE,
-        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
-        DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_enableHiZ(GPIO_I2C_OLED_IOMUX_SDA);
-    DL_GPIO_enableHiZ(GPIO_I2C_OLED_IOMUX_SCL);
-    DL_I2C_enablePower(I2C_OLED_INST);
-    SYSCFG_DL_I2C_OLED_init();
-    return 0;
-}
+#include "clock.h"
+#include "i2c_bus.h"
 
-void oled_i2c_sda_unlock(void)
-{
-    uint8_t cycleCnt = 0;
-    mspm0_i2c_disable();
-    do
-    {
-        DL_GPIO_clearPins(GPIO_I2C_OLED_SCL_PORT, GPIO_I2C_OLED_SCL_PIN);
-        mspm0_delay_ms(1);
-        DL_GPIO_setPins(GPIO_I2C_OLED_SCL_PORT, GPIO_I2C_OLED_SCL_PIN);
-        mspm0_delay_ms(1);
+#define OLED_I2C_ADDR   0x3C
 
-        if(DL_GPIO_readPins(GPIO_I2C_OLED_SDA_PORT, GPIO_I2C_OLED_SDA_PIN))
-            break;
-    }while(++cycleCnt < 100);
-    mspm0_i2c_enable();
-}
+// OLED作为共享I2C引擎的客户端；配置了DMA_OLED时页数据由DMA搬运，否则由FIFO中断补发
+#if defined DMA_OLED_CHAN_ID
+static const I2C_Bus_Config_t oled_bus_cfg = I2C_BUS_CONFIG_DMA(OLED, DMA_OLED);
+#else
+static const I2C_Bus_Config_t oled_bus_cfg = I2C_BUS_CONFIG(OLED);
+#endif
 
-//反显函数
-void OLED_ColorTurn(uint8_t i)
-{
-    if(i==0)
-    {
-        OLED_WR_Byte(0xA6,OLED_CMD);//正常显示
-    }
-    if(i==1)
-    {
-        OLED_WR_Byte(0xA7,OLED_CMD);//反色显示
-    }
-}
+static I2C_Bus_t *oled_bus;
+static I2C_Xfer_t page_xfer;
 
-//屏幕旋转180度
-void OLED_DisplayTurn(uint8_t i)
+//连续发送多个字节（一次I2C传输，只带一个控制字节）
+//mode:数据/命令标志 0,表示命令(控制字节0x00);1,表示数据(控制字节0x40);
+void OLED_Transport_Write(const uint8_t *dat, uint16_t len, uint8_t mode)
 {
-if(i==0)
-    {
-        OLED_WR_Byte(0xC8,OLED_CMD);//正常显示
-        OLED_WR_Byte(0xA1,OLED_CMD);
-    }
-    if(i==1)
-    {
-        OLED_WR_Byte(0xC0,OLED_CMD);//反转显示
-        OLED_WR_Byte(0xA0,OLED_CMD);
-    }
+    uint8_t control = mode ? 0x40 : 0x00;
+    I2C_Bus_Write(oled_bus, OLED_I2C_ADDR, &control, 1, dat, len);
 }
 
-//发送一个字节
-//向SSD1306写入一个字节。
-//mode:数据/命令标志 0,表示命令;1,表示数据;
-void OLED_WR_Byte(uint8_t dat,uint8_t mode)
+//一页发送结束（I2C中断中调用，超时恢复时在主循环中调用）
+static void OLED_PageDone(I2C_Xfer_t *xfer)
 {
-    unsigned char ptr[2];
-    unsigned long start, cur;
-
-    if(mode)
-    {
-        ptr[0] = 0x40;
-        ptr[1] = dat;
-    }
+    if (xfer->status == I2C_XFER_DONE)
+        OLED_TxDone_IRQHandler();
     else
-    {
-        ptr[0] = 0x00;
-        ptr[1] = dat;
-    }
-
-    mspm0_get_clock_ms(&start);
-
-    DL_I2C_fillControllerTXFIFO(I2C_OLED_INST, ptr, 2);
-    DL_I2C_clearInterruptStatus(I2C_OLED_INST, DL_I2C_INTERRUPT_CONTROLLER_TX_DONE);
-    while (!(DL_I2C_getControllerStatus(I2C_OLED_INST) & DL_I2C_CONTROLLER_STATUS_IDLE));
-    DL_I2C_startControllerTransfer(I2C_OLED_INST, 0x3C, DL_I2C_CONTROLLER_DIRECTION_TX, 2);
-
-    while (!DL_I2C_getRawInterruptStatus(I2C_OLED_INST, DL_I2C_INTERRUPT_CONTROLLER_TX_DONE))
-    {
-        mspm0_get_clock_ms(&cur);
-        if(cur >= (start + I2C_TIMEOUT_MS))
-        {
-            oled_i2c_sda_unlock();
-            break;
-        }
-    }
-}
-
-//坐标设置
-void OLED_Set_Pos(uint8_t x, uint8_t y) 
-{ 
-    OLED_WR_Byte(0xb0+y,OLED_CMD);
-    OLED_WR_Byte(((x&0xf0)>>4)|0x10,OLED_CMD);
-    OLED_WR_Byte((x&0x0f),OLED_CMD);
+        OLED_TxError_IRQHandler();
 }
 
-//开启OLED显示    
-void OLED_Display_On(void)
+//提交一页异步发送：一次传输发完定位命令和数据
+//0x80 页地址 0x80 列高 0x80 列低 0x40 数据...
+//（控制字节Co=1表示后面还有控制字节，最后的0x40之后全部是显存数据）
+bool OLED_Transport_PageAsync(uint8_t page, uint8_t x0, const uint8_t *dat, uint16_t len)
 {
-    OLED_WR_Byte(0X8D,OLED_CMD);  //SET DCDC命令
-    OLED_WR_Byte(0X14,OLED_CMD);  //DCDC ON
-    OLED_WR_Byte(0XAF,OLED_CMD);  //DISPLAY ON
-}
-
-//关闭OLED显示     
-void OLED_Display_Off(void)
+    page_xfer.addr = OLED_I2C_ADDR;
+    page_xfer.hdr[0] = 0x80;
+    page_xfer.hdr[1] = 0xb0 + page;
+    page_xfer.hdr[2] = 0x80;
+    page_xfer.hdr[3] = ((x0 & 0xf0) >> 4) | 0x10;
+    page_xfer.hdr[4] = 0x80;
+    page_xfer.hdr[5] = x0 & 0x0f;
+    page_xfer.hdr[6] = 0x40;
+    page_xfer.hdr_len = 7;
+    page_xfer.tx = dat;
+    page_xfer.tx_len = len;
+    page_xfer.rx = NULL;
+    page_xfer.rx_len = 0;
+    page_xfer.done = OLED_PageDone;
+
+    return I2C_Bus_Submit(oled_bus, &page_xfer);
+}
+
+//完成中断由I2C引擎常开，这里不需要额外操作
+void OLED_Transport_AsyncBegin(void)
 {
-    OLED_WR_Byte(0X8D,OLED_CMD);  //SET DCDC命令
-    OLED_WR_Byte(0X10,OLED_CMD);  //DCDC OFF
-    OLED_WR_Byte(0XAE,OLED_CMD);  //DISPLAY OFF
-}
-	 
-//清屏函数,清完屏,整个屏幕是黑色的!和没点亮一样!!!	  
-void OLED_Clear(void)  
-{  
-    uint8_t i,n;		    
-    for(i=0;i<8;i++)  
-    {  
-        OLED_WR_Byte (0xb0+i,OLED_CMD);    //设置页地址（0~7）
-        OLED_WR_Byte (0x00,OLED_CMD);      //设置显示位置—列低地址
-        OLED_WR_Byte (0x10,OLED_CMD);      //设置显示位置—列高地址   
-        for(n=0;n<128;n++)OLED_WR_Byte(0,OLED_DATA); 
-    } //更新显示
-}
-
-//在指定位置显示一个字符,包括部分字符
-//x:0~127
-//y:0~63				 
-//sizey:选择字体 6x8  8x16
-void OLED_ShowChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey)
-{      	
-    uint8_t c=0,sizex=sizey/2;
-    uint16_t i=0,size1;
-    if(sizey==8)size1=6;
-    else size1=(sizey/8+((sizey%8)?1:0))*(sizey/2);
-    c=chr-' ';//得到偏移后的值
-    OLED_Set_Pos(x,y);
-    for(i=0;i<size1;i++)
-    {
-        if(i%sizex==0&&sizey!=8) OLED_Set_Pos(x,y++);
-        if(sizey==8) OLED_WR_Byte(asc2_0806[c][i],OLED_DATA);//6X8字号
-        else if(sizey==16) OLED_WR_Byte(asc2_1608[c][i],OLED_DATA);//8x16字号
-        //		else if(sizey==xx) OLED_WR_Byte(asc2_xxxx[c][i],OLED_DATA);//用户添加字号
-        else return;
-    }
 }
 
-//m^n函数
-uint32_t oled_pow(uint8_t m,uint8_t n)
+void OLED_Transport_AsyncEnd(void)
 {
-    uint32_t result=1;	 
-    while(n--)result*=m;    
-    return result;
 }
 
-//显示数字
-//x,y :起点坐标
-//num:要显示的数字
-//len :数字的位数
-//sizey:字体大小		  
-void OLED_ShowNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len,uint8_t sizey)
-{         	
-    uint8_t t,temp,m=0;
-    uint8_t enshow=0;
-    if(sizey==8)m=2;
-    for(t=0;t<len;t++)
-    {
-        temp=(num/oled_pow(10,len-t-1))%10;
-        if(enshow==0&&t<(len-1))
-        {
-            if(temp==0)
-            {
-                OLED_ShowChar(x+(sizey/2+m)*t,y,' ',sizey);
-                continue;
-            }else enshow=1;
-        }
-        OLED_ShowChar(x+(sizey/2+m)*t,y,temp+'0',sizey);
-    }
-}
-
-//显示一个字符号串
-void OLED_ShowString(uint8_t x,uint8_t y,uint8_t *chr,uint8_t sizey)
-{
-    uint8_t j=0;
-    while (chr[j]!='\0')
-    {		
-        OLED_ShowChar(x,y,chr[j++],sizey);
-        if(sizey==8)x+=6;
-        else x+=sizey/2;
-    }
-}
-
-//显示汉字
-void OLED_ShowChinese(uint8_t x,uint8_t y,uint8_t no,uint8_t sizey)
+//等待刷新时检查超时：总线卡死时引擎中止传输并解锁SDA，页传输以超时结束
+void OLED_Transport_Poll(void)
 {
-    uint16_t i,size1=(sizey/8+((sizey%8)?1:0))*sizey;
-    for(i=0;i<size1;i++)
-    {
-        if(i%sizey==0) OLED_Set_Pos(x,y++);
-        if(sizey==16) OLED_WR_Byte(Hzk[no][i],OLED_DATA);//16x16字号
-        //		else if(sizey==xx) OLED_WR_Byte(xxx[c][i],OLED_DATA);//用户添加字号
-        else return;
-    }				
+    I2C_Bus_CheckTimeout(oled_bus);
 }
 
-//显示图片
-//x,y显示坐标
-//sizex,sizey,图片长宽
-//BMP：要显示的图片
-void OLED_DrawBMP(uint8_t x,uint8_t y,uint8_t sizex, uint8_t sizey,uint8_t BMP[])
-{ 	
-    uint16_t j=0;
-    uint8_t i,m;
-    sizey=sizey/8+((sizey%8)?1:0);
-    for(i=0;i<sizey;i++)
-    {
-        OLED_Set_Pos(x,i+y);
-        for(m=0;m<sizex;m++)
-        {      
-            OLED_WR_Byte(BMP[j++],OLED_DATA);	    	
-        }
-    }
-}
-
-//初始化SSD1306					    
-void OLED_Init(void)
+//打开总线（SDA被拉死时由引擎解锁），等待屏幕上电稳定
+void OLED_Transport_Init(void)
 {
-    if(DL_I2C_getSDAStatus(I2C_OLED_INST) == DL_I2C_CONTROLLER_SDA_LOW)
-        oled_i2c_sda_unlock();
-
+    oled_bus = I2C_Bus_Open(&oled_bus_cfg);
     delay_ms(200);
+}
 
-    OLED_WR_Byte(0xAE,OLED_CMD);//--turn off oled panel
-    OLED_WR_Byte(0x00,OLED_CMD);//---set low column address
-    OLED_WR_Byte(0x10,OLED_CMD);//---set high column address
-    OLED_WR_Byte(0x40,OLED_CMD);//--set start line address  Set Mapping RAM Display Start Line (0x00~0x3F)
-    OLED_WR_Byte(0x81,OLED_CMD);//--set contrast control register
-    OLED_WR_Byte(0xCF,OLED_CMD); // Set SEG Output Current Brightness
-    OLED_WR_Byte(0xA1,OLED_CMD);//--Set SEG/Column Mapping     0xa0左右反置 0xa1正常
-    OLED_WR_Byte(0xC8,OLED_CMD);//Set COM/Row Scan Direction   0xc0上下反置 0xc8正常
-    OLED_WR_Byte(0xA6,OLED_CMD);//--set normal display
-    OLED_WR_Byte(0xA8,OLED_CMD);//--set multiplex ratio(1 to 64)
-    OLED_WR_Byte(0x3f,OLED_CMD);//--1/64 duty
-    OLED_WR_Byte(0xD3,OLED_CMD);//-set display offset	Shift Mapping RAM Counter (0x00~0x3F)
-    OLED_WR_Byte(0x00,OLED_CMD);//-not offset
-    OLED_WR_Byte(0xd5,OLED_CMD);//--set display clock divide ratio/oscillator frequency
-    OLED_WR_Byte(0x80,OLED_CMD);//--set divide ratio, Set Clock as 100 Frames/Sec
-    OLED_WR_Byte(0xD9,OLED_CMD);//--set pre-charge period
-    OLED_WR_Byte(0xF1,OLED_CMD);//Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
-    OLED_WR_Byte(0xDA,OLED_CMD);//--set com pins hardware configuration
-    OLED_WR_Byte(0x12,OLED_CMD);
-    OLED_WR_Byte(0xDB,OLED_CMD);//--set vcomh
-    OLED_WR_Byte(0x40,OLED_CMD);//Set VCOM Deselect Level
-    OLED_WR_Byte(0x20,OLED_CMD);//-Set Page Addressing Mode (0x00/0x01/0x02)
-    OLED_WR_Byte(0x02,OLED_CMD);//
-    OLED_WR_Byte(0x8D,OLED_CMD);//--set Charge Pump enable/disable
-    OLED_WR_Byte(0x14,OLED_CMD);//--set(0x10) disable
-    OLED_WR_Byte(0xA4,OLED_CMD);// Disable Entire Display On (0xa4/0xa5)
-    OLED_WR_Byte(0xA6,OLED_CMD);// Disable Inverse Display On (0xa6/a7) 
-    OLED_Clear();
-    OLED_WR_Byte(0xAF,OLED_CMD); /*display ON*/ 
-}  
+#endif  /* OLED_TRANSPORT == OLED_TRANSPORT_HW_I2C */
@@ -1,233 +1,94 @@
-#include "oled_hardware_spi.h"
-#include "oledfont.h"
-#include "clock.h"
+#include "oled.h"
 
-//OLED的显存
-//存放格式如下.
-//[0]0 1 2 3 ... 127	
-//[1]0 1 2 3 ... 127	
-//[2]0 1 2 3 ... 127	
-//[3]0 1 2 3 ... 127	
-//[4]0 1 2 3 ... 127	
-//[5]0 1 2 3 ... 127	
-//[6]0 1 2 3 ... 127	
-//[7]0 1 2 3 ... 127
-
-void delay_ms(uint32_t ms)
-{
-    mspm0_delay_ms(ms);
-}
+#if OLED_TRANSPORT == OLED_TRANSPORT_HW_SPI
 
-//反显函数
-void OLED_ColorTurn(uint8_t i)
-{
-    if(i==0)
-    {
-        OLED_WR_Byte(0xA6,OLED_CMD);//正常显示
-    }
-    if(i==1)
-    {
-        OLED_WR_Byte(0xA7,OLED_CMD);//反色显示
-    }
-}
+#include "clock.h"
 
-//屏幕旋转180度
-void OLED_DisplayTurn(uint8_t i)
+//连续发送多个字节，整段使用同一个命令/数据模式
+//mode:数据/命令标志 0,表示命令;1,表示数据;
+void OLED_Transport_Write(const uint8_t *dat, uint16_t len, uint8_t mode)
 {
-    if(i==0)
-    {
-        OLED_WR_Byte(0xC8,OLED_CMD);//正常显示
-        OLED_WR_Byte(0xA1,OLED_CMD);
-    }
-    if(i==1)
-    {
-        OLED_WR_Byte(0xC0,OLED_CMD);//反转显示
-        OLED_WR_Byte(0xA0,OLED_CMD);
-    }
-}
+    uint16_t i;
 
-void OLED_WR_Byte(uint8_t dat,uint8_t cmd)
-{
     while (DL_SPI_isBusy(SPI_OLED_INST));
 
-    if(cmd)
+    if(mode)
         DL_SPI_setControllerCommandDataModeConfig(SPI_OLED_INST, DL_SPI_CD_MODE_DATA);
     else
         DL_SPI_setControllerCommandDataModeConfig(SPI_OLED_INST, DL_SPI_CD_MODE_COMMAND);
 
-    DL_SPI_transmitData8(SPI_OLED_INST, dat);
-} 
-
-//坐标设置
-void OLED_Set_Pos(uint8_t x, uint8_t y) 
-{ 
-    OLED_WR_Byte(0xb0+y,OLED_CMD);
-    OLED_WR_Byte(((x&0xf0)>>4)|0x10,OLED_CMD);
-    OLED_WR_Byte((x&0x0f),OLED_CMD);
+    for(i = 0; i < len; i++)
+    {
+        while (DL_SPI_isTXFIFOFull(SPI_OLED_INST));
+        DL_SPI_transmitData8(SPI_OLED_INST, dat[i]);
+    }
 }
 
-//开启OLED显示    
-void OLED_Display_On(void)
-{
-    OLED_WR_Byte(0X8D,OLED_CMD);  //SET DCDC命令
-    OLED_WR_Byte(0X14,OLED_CMD);  //DCDC ON
-    OLED_WR_Byte(0XAF,OLED_CMD);  //DISPLAY ON
-}
+#if OLED_TRANSPORT_ASYNC
+//一页DMA发送的超时时间（ms），一页最多128字节，正常远小于1ms
+#define OLED_SPI_PAGE_TIMEOUT_MS 5
 
-//关闭OLED显示     
-void OLED_Display_Off(void)
-{
-    OLED_WR_Byte(0X8D,OLED_CMD);  //SET DCDC命令
-    OLED_WR_Byte(0X10,OLED_CMD);  //DCDC OFF
-    OLED_WR_Byte(0XAE,OLED_CMD);  //DISPLAY OFF
-}
+static volatile uint32_t page_start_ms;    //当前页开始发送的时刻
 
-//清屏函数,清完屏,整个屏幕是黑色的!和没点亮一样!!!	  
-void OLED_Clear(void)  
-{  
-    uint8_t i,n;		    
-    for(i=0;i<8;i++)  
-    {  
-        OLED_WR_Byte (0xb0+i,OLED_CMD);    //设置页地址（0~7）
-        OLED_WR_Byte (0x00,OLED_CMD);      //设置显示位置—列低地址
-        OLED_WR_Byte (0x10,OLED_CMD);      //设置显示位置—列高地址   
-        for(n=0;n<128;n++)OLED_WR_Byte(0,OLED_DATA); 
-    } //更新显示
-}
+//启动一页DMA发送
+//命令/数据模式设为3：硬件自动把前3个字节（页地址、列高、列低）作为命令发送，之后切换为数据
+//上一页留下的IDLE标志在写命令字节之前清除：之后任何时刻被抢占，本页结束产生的IDLE事件都不会被清掉
+bool OLED_Transport_PageAsync(uint8_t page, uint8_t x0, const uint8_t *dat, uint16_t len)
+{
+    while (DL_SPI_isBusy(SPI_OLED_INST));
 
-//在指定位置显示一个字符,包括部分字符
-//x:0~127
-//y:0~63				 
-//sizey:选择字体 6x8  8x16
-void OLED_ShowChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey)
-{      	
-    uint8_t c=0,sizex=sizey/2;
-    uint16_t i=0,size1;
-    if(sizey==8)size1=6;
-    else size1=(sizey/8+((sizey%8)?1:0))*(sizey/2);
-    c=chr-' ';//得到偏移后的值
-    OLED_Set_Pos(x,y);
-    for(i=0;i<size1;i++)
-    {
-        if(i%sizex==0&&sizey!=8) OLED_Set_Pos(x,y++);
-        if(sizey==8) OLED_WR_Byte(asc2_0806[c][i],OLED_DATA);//6X8字号
-        else if(sizey==16) OLED_WR_Byte(asc2_1608[c][i],OLED_DATA);//8x16字号
-        //		else if(sizey==xx) OLED_WR_Byte(asc2_xxxx[c][i],OLED_DATA);//用户添加字号
-        else return;
-    }
+    DL_SPI_clearInterruptStatus(SPI_OLED_INST, DL_SPI_INTERRUPT_IDLE);
+    page_start_ms = tick_ms;
+    DL_SPI_setControllerCommandDataModeConfig(SPI_OLED_INST, 3);
+    DL_SPI_transmitData8(SPI_OLED_INST, 0xb0 + page);
+    DL_SPI_transmitData8(SPI_OLED_INST, ((x0 & 0xf0) >> 4) | 0x10);
+    DL_SPI_transmitData8(SPI_OLED_INST, x0 & 0x0f);
+
+    DL_DMA_setSrcAddr(DMA, DMA_OLED_CHAN_ID, (uint32_t)dat);
+    DL_DMA_setDestAddr(DMA, DMA_OLED_CHAN_ID, (uint32_t)&SPI_OLED_INST->TXDATA);
+    DL_DMA_setTransferSize(DMA, DMA_OLED_CHAN_ID, len);
+    DL_DMA_enableChannel(DMA, DMA_OLED_CHAN_ID);
+    return true;
 }
 
-//m^n函数
-uint32_t oled_pow(uint8_t m,uint8_t n)
+//开启SPI空闲中断（一页全部移出时进入OLED_TxDone_IRQHandler）
+void OLED_Transport_AsyncBegin(void)
 {
-    uint32_t result=1;	 
-    while(n--)result*=m;    
-    return result;
+    DL_SPI_enableInterrupt(SPI_OLED_INST, DL_SPI_INTERRUPT_IDLE);
 }
 
-//显示数字
-//x,y :起点坐标
-//num:要显示的数字
-//len :数字的位数
-//sizey:字体大小		  
-void OLED_ShowNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len,uint8_t sizey)
-{         	
-    uint8_t t,temp,m=0;
-    uint8_t enshow=0;
-    if(sizey==8)m=2;
-    for(t=0;t<len;t++)
-    {
-        temp=(num/oled_pow(10,len-t-1))%10;
-        if(enshow==0&&t<(len-1))
-        {
-            if(temp==0)
-            {
-                OLED_ShowChar(x+(sizey/2+m)*t,y,' ',sizey);
-                continue;
-            }else enshow=1;
-        }
-        OLED_ShowChar(x+(sizey/2+m)*t,y,temp+'0',sizey);
-    }
-}
-
-//显示一个字符号串
-void OLED_ShowString(uint8_t x,uint8_t y,uint8_t *chr,uint8_t sizey)
+void OLED_Transport_AsyncEnd(void)
 {
-    uint8_t j=0;
-    while (chr[j]!='\0')
-    {		
-        OLED_ShowChar(x,y,chr[j++],sizey);
-        if(sizey==8)x+=6;
-        else x+=sizey/2;
-    }
+    DL_SPI_disableInterrupt(SPI_OLED_INST, DL_SPI_INTERRUPT_IDLE);
 }
 
-//显示汉字
-void OLED_ShowChinese(uint8_t x,uint8_t y,uint8_t no,uint8_t sizey)
+//等待刷新时检查超时：一页超过OLED_SPI_PAGE_TIMEOUT_MS仍未结束（IDLE事件丢失、DMA未启动）时
+//停止DMA并以出错结束刷新，本页重新标脏，下一次刷新补发
+//关中断检查，避免与正常结束的OLED_TxDone_IRQHandler交错
+void OLED_Transport_Poll(void)
 {
-    uint16_t i,size1=(sizey/8+((sizey%8)?1:0))*sizey;
-    for(i=0;i<size1;i++)
-    {
-        if(i%sizey==0) OLED_Set_Pos(x,y++);
-        if(sizey==16) OLED_WR_Byte(Hzk[no][i],OLED_DATA);//16x16字号
-        //		else if(sizey==xx) OLED_WR_Byte(xxx[c][i],OLED_DATA);//用户添加字号
-        else return;
-    }				
-}
+    uint32_t primask = __get_PRIMASK();
 
-//显示图片
-//x,y显示坐标
-//sizex,sizey,图片长宽
-//BMP：要显示的图片
-void OLED_DrawBMP(uint8_t x,uint8_t y,uint8_t sizex, uint8_t sizey,uint8_t BMP[])
-{ 	
-    uint16_t j=0;
-    uint8_t i,m;
-    sizey=sizey/8+((sizey%8)?1:0);
-    for(i=0;i<sizey;i++)
-    {
-        OLED_Set_Pos(x,i+y);
-        for(m=0;m<sizex;m++)
-        {      
-            OLED_WR_Byte(BMP[j++],OLED_DATA);	    	
-        }
+    __disable_irq();
+    if ((uint32_t)(tick_ms - page_start_ms) > OLED_SPI_PAGE_TIMEOUT_MS) {
+        DL_DMA_disableChannel(DMA, DMA_OLED_CHAN_ID);
+        OLED_TxError_IRQHandler();
     }
+    __set_PRIMASK(primask);
 }
+#endif
 
-//初始化SSD1306					    
-void OLED_Init(void)
+//复位屏幕
+void OLED_Transport_Init(void)
 {
     OLED_RES_Clr();
     delay_ms(200);
     OLED_RES_Set();
-    
-    OLED_WR_Byte(0xAE,OLED_CMD);//--turn off oled panel
-    OLED_WR_Byte(0x00,OLED_CMD);//---set low column address
-    OLED_WR_Byte(0x10,OLED_CMD);//---set high column address
-    OLED_WR_Byte(0x40,OLED_CMD);//--set start line address  Set Mapping RAM Display Start Line (0x00~0x3F)
-    OLED_WR_Byte(0x81,OLED_CMD);//--set contrast control register
-    OLED_WR_Byte(0xCF,OLED_CMD); // Set SEG Output Current Brightness
-    OLED_WR_Byte(0xA1,OLED_CMD);//--Set SEG/Column Mapping     0xa0左右反置 0xa1正常
-    OLED_WR_Byte(0xC8,OLED_CMD);//Set COM/Row Scan Direction   0xc0上下反置 0xc8正常
-    OLED_WR_Byte(0xA6,OLED_CMD);//--set normal display
-    OLED_WR_Byte(0xA8,OLED_CMD);//--set multiplex ratio(1 to 64)
-    OLED_WR_Byte(0x3f,OLED_CMD);//--1/64 duty
-    OLED_WR_Byte(0xD3,OLED_CMD);//-set display offset	Shift Mapping RAM Counter (0x00~0x3F)
-    OLED_WR_Byte(0x00,OLED_CMD);//-not offset
-    OLED_WR_Byte(0xd5,OLED_CMD);//--set display clock divide ratio/oscillator frequency
-    OLED_WR_Byte(0x80,OLED_CMD);//--set divide ratio, Set Clock as 100 Frames/Sec
-    OLED_WR_Byte(0xD9,OLED_CMD);//--set pre-charge period
-    OLED_WR_Byte(0xF1,OLED_CMD);//Set Pre-Charge as 15 Clocks & Discharge as 1 Clock
-    OLED_WR_Byte(0xDA,OLED_CMD);//--set com pins hardware configuration
-    OLED_WR_Byte(0x12,OLED_CMD);
-    OLED_WR_Byte(0xDB,OLED_CMD);//--set vcomh
-    OLED_WR_Byte(0x40,OLED_CMD);//Set VCOM Deselect Level
-    OLED_WR_Byte(0x20,OLED_CMD);//-Set Page Addressing Mode (0x00/0x01/0x02)
-    OLED_WR_Byte(0x02,OLED_CMD);//
-    OLED_WR_Byte(0x8D,OLED_CMD);//--set Charge Pump enable/disable
-    OLED_WR_Byte(0x14,OLED_CMD);//--set(0x10) disable
-    OLED_WR_Byte(0xA4,OLED_CMD);// Disable Entire Display On (0xa4/0xa5)
-    OLED_WR_Byte(0xA6,OLED_CMD);// Disable Inverse Display On (0xa6/a7) 
-    OLED_Clear();
-    OLED_WR_Byte(0xAF,OLED_CMD); /*display ON*/ 
-}  
+
+#if OLED_TRANSPORT_ASYNC
+    DL_SPI_disableInterrupt(SPI_OLED_INST, DL_SPI_INTERRUPT_IDLE);
+    NVIC_EnableIRQ(SPI_OLED_INST_INT_IRQN);
+#endif
+}
+
+#endif  /* OLED_TRANSPORT == OLED_TRANSPORT_HW_SPI */
@@ -12,6 +12,16 @@
  *     2. Name the group as "GPIO_OLED".
  *     3. Name the pin as "PIN_RES".
  *     4. Set the pin according to your needs.
+ *   DMA (optional, for OLED_FlushAsync):
+ *     1. Set "Configure DMA TX Trigger" of SPI_OLED to "SPI TX interrupt".
+ *     2. Set "DMA Channel TX Name" to "DMA_OLED".
+ *     3. Set "Address Mode" to "Block addr. to Fixed addr.".
+ *     4. Set "Source Length" and "Destination Length" to "Byte".
+ *     5. Enable "Source Address Increment".
+ *   Without DMA_OLED, OLED_FlushAsync falls back to a blocking refresh.
+ *
+ * 硬件SPI传输层，由oled.h在OLED_TRANSPORT == OLED_TRANSPORT_HW_SPI时引入，
+ * 应用代码请包含oled.h。
  */
 
 #ifndef __OLED_HARDWARE_SPI_H
@@ -19,8 +29,9 @@
 
 #include "ti_msp_dl_config.h"
 
-#define OLED_CMD  0	//写命令
-#define OLED_DATA 1	//写数据
+#if defined DMA_OLED_CHAN_ID
+#define OLED_TRANSPORT_ASYNC 1
+#endif
 
 #ifndef GPIO_OLED_PIN_RES_PORT
 #define GPIO_OLED_PIN_RES_PORT GPIO_OLED_PORT 
@@ -32,21 +43,4 @@
 #define		OLED_RES_Clr()			    (DL_GPIO_clearPins(GPIO_OLED_PIN_RES_PORT, GPIO_OLED_PIN_RES_PIN))
 					   
 
-//OLED控制用函数
-void delay_ms(uint32_t ms);
-void OLED_ColorTurn(uint8_t i);
-void OLED_DisplayTurn(uint8_t i);
-void OLED_WR_Byte(uint8_t dat,uint8_t cmd);
-void OLED_Set_Pos(uint8_t x, uint8_t y);
-void OLED_Display_On(void);
-void OLED_Display_Off(void);
-void OLED_Clear(void);
-void OLED_ShowChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey);
-uint32_t oled_pow(uint8_t m,uint8_t n);
-void OLED_ShowNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len,uint8_t sizey);
-void OLED_ShowString(uint8_t x,uint8_t y,uint8_t *chr,uint8_t sizey);
-void OLED_ShowChinese(uint8_t x,uint8_t y,uint8_t no,uint8_t sizey);
-void OLED_DrawBMP(uint8_t x,uint8_t y,uint8_t sizex, uint8_t sizey,uint8_t BMP[]);
-void OLED_Init(void);
-
 #endif /* #ifndef __OLED_HARDWARE_SPI_H */
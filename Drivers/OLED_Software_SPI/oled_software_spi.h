@@ -5,6 +5,9 @@
  *     2. Name the group as "GPIO_OLED".
  *     3. Name the pins as "PIN_SCL", "PIN_SDA", "PIN_RES", "PIN_DC" and "PIN_CS".
  *     4. Set the pins according to your needs.
+ *
+ * 软件SPI传输层，由oled.h在OLED_TRANSPORT == OLED_TRANSPORT_SW_SPI时引入，
+ * 应用代码请包含oled.h。
  */
 
 #ifndef __OLED_SOFTWARE_SPI_H
@@ -12,9 +15,6 @@
 
 #include "ti_msp_dl_config.h"
 
-#define OLED_CMD  0	//写命令
-#define OLED_DATA 1	//写数据
-
 #ifndef GPIO_OLED_PIN_SCL_PORT
 #define GPIO_OLED_PIN_SCL_PORT GPIO_OLED_PORT 
 #endif
@@ -61,21 +61,4 @@
 #define		OLED_CS_Clr()			    (DL_GPIO_clearPins(GPIO_OLED_PIN_CS_PORT, GPIO_OLED_PIN_CS_PIN))
 					   
 
-//OLED控制用函数
-void delay_ms(uint32_t ms);
-void OLED_ColorTurn(uint8_t i);
-void OLED_DisplayTurn(uint8_t i);
-void OLED_WR_Byte(uint8_t dat,uint8_t cmd);
-void OLED_Set_Pos(uint8_t x, uint8_t y);
-void OLED_Display_On(void);
-void OLED_Display_Off(void);
-void OLED_Clear(void);
-void OLED_ShowChar(uint8_t x,uint8_t y,uint8_t chr,uint8_t sizey);
-uint32_t oled_pow(uint8_t m,uint8_t n);
-void OLED_ShowNum(uint8_t x,uint8_t y,uint32_t num,uint8_t len,uint8_t sizey);
-void OLED_ShowString(uint8_t x,uint8_t y,uint8_t *chr,uint8_t sizey);
-void OLED_ShowChinese(uint8_t x,uint8_t y,uint8_t no,uint8_t sizey);
-void OLED_DrawBMP(uint8_t x,uint8_t y,uint8_t sizex, uint8_t sizey,uint8_t BMP[]);
-void OLED_Init(void);
-
 #endif /* #ifndef __OLED_SOFTWARE_SPI_H */
@@ -5,9 +5,8 @@
 #include "ti_msp_dl_config.h"
 #include <string.h>
 #include "clock.h"
+#include "i2c_bus.h"
 
-#define I2C_TIME_OUT_BASE   10
-#define I2C_TIME_OUT_BYTE   1
 #define VL53L0X_OsDelay(...) mspm0_delay_ms(2)
 
 //extern I2C_HandleTypeDef hi2c1;
@@ -33,139 +32,32 @@
 
 uint8_t _I2CBuffer[64];
 
-void _I2CDisable(void)
-{
-    DL_I2C_reset(I2C_VL53L0X_INST);
-    DL_GPIO_initDigitalOutput(GPIO_I2C_VL53L0X_IOMUX_SCL);
-    DL_GPIO_initDigitalInputFeatures(GPIO_I2C_VL53L0X_IOMUX_SDA,
-		 DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_NONE,
-		 DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_clearPins(GPIO_I2C_VL53L0X_SCL_PORT, GPIO_I2C_VL53L0X_SCL_PIN);
-    DL_GPIO_enableOutput(GPIO_I2C_VL53L0X_SCL_PORT, GPIO_I2C_VL53L0X_SCL_PIN);
-}
-
-void _I2CEnable(void)
-{
-    DL_I2C_reset(I2C_VL53L0X_INST);
-    DL_GPIO_initPeripheralInputFunctionFeatures(GPIO_I2C_VL53L0X_IOMUX_SDA,
-        GPIO_I2C_VL53L0X_IOMUX_SDA_FUNC, DL_GPIO_INVERSION_DISABLE,
-        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
-        DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_initPeripheralInputFunctionFeatures(GPIO_I2C_VL53L0X_IOMUX_SCL,
-        GPIO_I2C_VL53L0X_IOMUX_SCL_FUNC, DL_GPIO_INVERSION_DISABLE,
-        DL_GPIO_RESISTOR_NONE, DL_GPIO_HYSTERESIS_DISABLE,
-        DL_GPIO_WAKEUP_DISABLE);
-    DL_GPIO_enableHiZ(GPIO_I2C_VL53L0X_IOMUX_SDA);
-    DL_GPIO_enableHiZ(GPIO_I2C_VL53L0X_IOMUX_SCL);
-    DL_I2C_enablePower(I2C_VL53L0X_INST);
-    SYSCFG_DL_I2C_VL53L0X_init();
-}
-
-void _I2CUnlock(void)
-{
-    uint8_t cycleCnt = 0;
-    _I2CDisable();
-    do
-    {
-        DL_GPIO_clearPins(GPIO_I2C_VL53L0X_SCL_PORT, GPIO_I2C_VL53L0X_SCL_PIN);
-        mspm0_delay_ms(1);
-        DL_GPIO_setPins(GPIO_I2C_VL53L0X_SCL_PORT, GPIO_I2C_VL53L0X_SCL_PIN);
-        mspm0_delay_ms(1);
-
-        if(DL_GPIO_readPins(GPIO_I2C_VL53L0X_SDA_PORT, GPIO_I2C_VL53L0X_SDA_PIN))
-            break;
-    }while(++cycleCnt < 100);
-    _I2CEnable();
-}
+// VL53L0X作为共享I2C引擎的客户端，传输由中断推进，超时和SDA解锁由引擎处理
+static const I2C_Bus_Config_t vl53l0x_bus_cfg = I2C_BUS_CONFIG(VL53L0X);
 
 int _I2CWrite(VL53L0X_DEV Dev, uint8_t *pdata, uint32_t count)
 {
-    int i2c_time_out = I2C_TIME_OUT_BASE+ count* I2C_TIME_OUT_BYTE;
-    unsigned int cnt = count;
-    unsigned char const *ptr = pdata;
-    unsigned long start, cur;
-
-    if (!pdata)
+    if (!pdata || !count)
         return 0;
 
-    mspm0_get_clock_ms(&start);
-
-    DL_I2C_clearInterruptStatus(I2C_VL53L0X_INST, DL_I2C_INTERRUPT_CONTROLLER_TX_DONE);
-
-    while (!(DL_I2C_getControllerStatus(I2C_VL53L0X_INST) & DL_I2C_CONTROLLER_STATUS_IDLE));
-
-    DL_I2C_startControllerTransfer(I2C_VL53L0X_INST, Dev->I2cDevAddr, DL_I2C_CONTROLLER_DIRECTION_TX, count);
-
-    do {
-        unsigned fillcnt;
-        fillcnt = DL_I2C_fillControllerTXFIFO(I2C_VL53L0X_INST, ptr, cnt);
-        cnt -= fillcnt;
-        ptr += fillcnt;
-
-        mspm0_get_clock_ms(&cur);
-        if(cur >= (start + i2c_time_out))
-        {
-            _I2CUnlock();
-            return -1;
-        }
-    } while (!DL_I2C_getRawInterruptStatus(I2C_VL53L0X_INST, DL_I2C_INTERRUPT_CONTROLLER_TX_DONE));
-
-    return 0;
+    return I2C_Bus_Write(I2C_Bus_Open(&vl53l0x_bus_cfg), Dev->I2cDevAddr, NULL, 0, pdata, count);
 }
 
 int _I2CRead(VL53L0X_DEV Dev, uint8_t *pdata, uint32_t count)
 {
-    int status;
-    int i2c_time_out = I2C_TIME_OUT_BASE+ count* I2C_TIME_OUT_BYTE;
-    unsigned i = 0;
-    unsigned long start, cur;
-
     if (!count)
         return 0;
 
-    mspm0_get_clock_ms(&start);
-
-    DL_I2C_clearInterruptStatus(I2C_VL53L0X_INST, DL_I2C_INTERRUPT_CONTROLLER_RX_DONE);
-
-    while (!(DL_I2C_getControllerStatus(I2C_VL53L0X_INST) & DL_I2C_CONTROLLER_STATUS_IDLE));
-
-    DL_I2C_startControllerTransfer(I2C_VL53L0X_INST, Dev->I2cDevAddr|1, DL_I2C_CONTROLLER_DIRECTION_RX, count);
-
-    do {
-        if (!DL_I2C_isControllerRXFIFOEmpty(I2C_VL53L0X_INST))
-        {
-            uint8_t c;
-            c = DL_I2C_receiveControllerData(I2C_VL53L0X_INST);
-            if (i < count)
-            {
-                pdata[i] = c;
-                ++i;
-            }
-        }
-        
-        mspm0_get_clock_ms(&cur);
-        if(cur >= (start + i2c_time_out))
-        {
-            _I2CUnlock();
-            return -1;
-        }
-    } while(!DL_I2C_getRawInterruptStatus(I2C_VL53L0X_INST, DL_I2C_INTERRUPT_CONTROLLER_RX_DONE));
-
-    if (!DL_I2C_isControllerRXFIFOEmpty(I2C_VL53L0X_INST))
-    {
-        uint8_t c;
-        c = DL_I2C_receiveControllerData(I2C_VL53L0X_INST);
-        if (i < count)
-        {
-            pdata[i] = c;
-            ++i;
-        }
-    }
+    return I2C_Bus_Read(I2C_Bus_Open(&vl53l0x_bus_cfg), Dev->I2cDevAddr, pdata, count);
+}
 
-    if(i == count)
+// 写寄存器地址后重复起始读数据（一次传输，中间不发STOP）
+int _I2CReadReg(VL53L0X_DEV Dev, uint8_t index, uint8_t *pdata, uint32_t count)
+{
+    if (!count)
         return 0;
-    else
-        return -1;
+
+    return I2C_Bus_ReadReg(I2C_Bus_Open(&vl53l0x_bus_cfg), Dev->I2cDevAddr, index, pdata, count);
 }
 
 // the ranging_sensor_comms.dll will take care of the page selection
@@ -191,16 +83,10 @@ VL53L0X_Error VL53L0X_ReadMulti(VL53L0X_DEV Dev, uint8_t index, uint8_t *pdata,
     VL53L0X_Error Status = VL53L0X_ERROR_NONE;
     int32_t status_int;
     VL53L0X_GetI2cBus();
-    status_int = _I2CWrite(Dev, &index, 1);
-    if (status_int != 0) {
-        Status = VL53L0X_ERROR_CONTROL_INTERFACE;
-        goto done;
-    }
-    status_int = _I2CRead(Dev, pdata, count);
+    status_int = _I2CReadReg(Dev, index, pdata, count);
     if (status_int != 0) {
         Status = VL53L0X_ERROR_CONTROL_INTERFACE;
     }
-done:
     VL53L0X_PutI2cBus();
     return Status;
 }
@@ -274,16 +160,10 @@ VL53L0X_Error VL53L0X_RdByte(VL53L0X_DEV Dev, uint8_t index, uint8_t *data) {
     int32_t status_int;
 
     VL53L0X_GetI2cBus();
-    status_int = _I2CWrite(Dev, &index, 1);
-    if( status_int ){
-        Status = VL53L0X_ERROR_CONTROL_INTERFACE;
-        goto done;
-    }
-    status_int = _I2CRead(Dev, data, 1);
+    status_int = _I2CReadReg(Dev, index, data, 1);
     if (status_int != 0) {
         Status = VL53L0X_ERROR_CONTROL_INTERFACE;
     }
-done:
     VL53L0X_PutI2cBus();
     return Status;
 }
@@ -293,13 +173,7 @@ VL53L0X_Error VL53L0X_RdWord(VL53L0X_DEV Dev, uint8_t index, uint16_t *data) {
     int32_t status_int;
 
     VL53L0X_GetI2cBus();
-    status_int = _I2CWrite(Dev, &index, 1);
-
-    if( status_int ){
-        Status = VL53L0X_ERROR_CONTROL_INTERFACE;
-        goto done;
-    }
-    status_int = _I2CRead(Dev, _I2CBuffer, 2);
+    status_int = _I2CReadReg(Dev, index, _I2CBuffer, 2);
     if (status_int != 0) {
         Status = VL53L0X_ERROR_CONTROL_INTERFACE;
         goto done;
@@ -316,12 +190,7 @@ VL53L0X_Error VL53L0X_RdDWord(VL53L0X_DEV Dev, uint8_t index, uint32_t *data) {
     int32_t status_int;
 
     VL53L0X_GetI2cBus();
-    status_int = _I2CWrite(Dev, &index, 1);
-    if (status_int != 0) {
-        Status = VL53L0X_ERROR_CONTROL_INTERFACE;
-        goto done;
-    }
-    status_int = _I2CRead(Dev, _I2CBuffer, 4);
+    status_int = _I2CReadReg(Dev, index, _I2CBuffer, 4);
     if (status_int != 0) {
         Status = VL53L0X_ERROR_CONTROL_INTERFACE;
         goto done;
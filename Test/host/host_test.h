@@ -0,0 +1,37 @@
+/*
+ * host_test.h
+ *
+ *  主机单元测试公用宏 - 在PC上编译运行，只测试不依赖硬件的纯逻辑模块
+ */
+
+#ifndef TEST_HOST_HOST_TEST_H_
+#define TEST_HOST_HOST_TEST_H_
+
+#include <stdio.h>
+#include <math.h>
+
+static int host_test_failures = 0;
+
+// 条件不成立时打印位置并记一次失败（不中断，继续执行后面的检查）
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        host_test_failures++; \
+    } \
+} while (0)
+
+// 浮点比较：|a - b| <= tol
+#define CHECK_NEAR(a, b, tol) do { \
+    double _a = (double)(a), _b = (double)(b); \
+    if (!(fabs(_a - _b) <= (double)(tol))) { \
+        printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g (tol %g)\n", \
+               __FILE__, __LINE__, #a, #b, _a, _b, (double)(tol)); \
+        host_test_failures++; \
+    } \
+} while (0)
+
+// 在main末尾返回：打印结果，有失败时返回1
+#define HOST_TEST_RESULT(name) \
+    (printf("%s: %s\n", (name), host_test_failures ? "FAIL" : "PASS"), host_test_failures ? 1 : 0)
+
+#endif /* TEST_HOST_HOST_TEST_H_ */
@@ -0,0 +1,14 @@
+/*
+ * ti_msp_dl_config.h（主机测试桩）
+ *
+ *  被测模块通过Encoder.h等头文件间接包含SysConfig生成的配置头，主机上没有外设，
+ *  这里只提供空文件让头文件能编译；被测模块用到的硬件函数由各测试自己打桩。
+ */
+
+#ifndef TEST_HOST_STUB_TI_MSP_DL_CONFIG_H_
+#define TEST_HOST_STUB_TI_MSP_DL_CONFIG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#endif /* TEST_HOST_STUB_TI_MSP_DL_CONFIG_H_ */
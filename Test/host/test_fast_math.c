@@ -0,0 +1,101 @@
+/*
+ * test_fast_math.c
+ *
+ *  快速数学函数精度测试
+ *
+ *  atan2在整个圆周（含不同半径、坐标轴和原点）上与双精度atan2比较，asin在[-1, 1]上与asin比较，
+ *  开方/除法在约2^-20 ~ 2^20的数量级上检查相对误差，四元数转欧拉角与双精度公式比较。
+ *  耗时只能在板上测（Test/test.c中的Test_FastMath_Accuracy）。
+ */
+
+#include "host_test.h"
+#include "fast_math.h"
+#include <stdint.h>
+
+#define FM_TEST_N           20000       // 每项的取点数
+#define FM_MAX_ERR_RAD      3e-6        // atan2/asin允许的最大误差（弧度，多项式误差约2e-6）
+#define FM_MAX_ERR_REL      1e-6        // 开方、除法允许的最大相对误差
+#define FM_MAX_ERR_EULER    5e-4        // 欧拉角允许的最大误差（度，含单精度输入的舍入）
+
+#define PI_D                3.14159265358979323846
+
+static double Max(double a, double b)
+{
+    return a > b ? a : b;
+}
+
+int main(void)
+{
+    double err_atan2 = 0.0, err_asin = 0.0, err_rel = 0.0, err_euler = 0.0;
+    uint32_t seed = 1;
+
+    for (int i = 0; i < FM_TEST_N; i++) {
+        // 圆周上均匀取点，半径跨越几个数量级（比值与缩放无关）
+        double a = -PI_D + 2.0 * PI_D * i / FM_TEST_N;
+        double r = ldexp(1.0, i % 21 - 10);
+        float s = (float)(r * sin(a)), c = (float)(r * cos(a));
+        err_atan2 = Max(err_atan2, fabs(FastMath_Atan2(s, c) - atan2((double)s, (double)c)));
+
+        float x = -1.0f + 2.0f * i / (FM_TEST_N - 1);
+        err_asin = Max(err_asin, fabs(FastMath_Asin(x) - asin((double)x)));
+
+        float v = ldexpf(1.0f + (float)i / FM_TEST_N, i % 41 - 20);
+        err_rel = Max(err_rel, fabs(FastMath_Sqrt(v) / sqrt((double)v) - 1.0));
+        if (c != 0.0f) {
+            err_rel = Max(err_rel, fabs(FastMath_Div(c, v) / ((double)c / v) - 1.0));
+        }
+    }
+
+    // 坐标轴和原点
+    CHECK(FastMath_Atan2(0.0f, 0.0f) == 0.0f);
+    CHECK_NEAR(FastMath_Atan2(1.0f, 0.0f), PI_D / 2, FM_MAX_ERR_RAD);
+    CHECK_NEAR(FastMath_Atan2(-1.0f, 0.0f), -PI_D / 2, FM_MAX_ERR_RAD);
+    CHECK_NEAR(FastMath_Atan2(0.0f, -1.0f), PI_D, FM_MAX_ERR_RAD);
+    CHECK_NEAR(FastMath_Atan2(0.0f, 1.0f), 0.0, FM_MAX_ERR_RAD);
+
+    // asin超出[-1, 1]时钳位，开方负数返回0
+    CHECK(FastMath_Asin(1.001f) == FAST_MATH_HALF_PI);
+    CHECK(FastMath_Asin(-1.001f) == -FAST_MATH_HALF_PI);
+    CHECK(FastMath_Sqrt(-4.0f) == 0.0f);
+
+    // 伪随机单位四元数转欧拉角，与双精度公式比较（俯仰角避开±90°奇异点附近）
+    for (int i = 0; i < FM_TEST_N; i++) {
+        double q[4], n = 0.0;
+        for (int k = 0; k < 4; k++) {
+            seed = seed * 1103515245u + 12345u;
+            q[k] = (double)((seed >> 8) & 0xFFFF) / 32768.0 - 1.0;
+            n += q[k] * q[k];
+        }
+        if (n < 1e-3) continue;
+        n = sqrt(n);
+        for (int k = 0; k < 4; k++) q[k] /= n;
+
+        double w = q[0], qx = q[1], qy = q[2], qz = q[3];
+        double sp = 2.0 * (w * qy - qz * qx);
+        if (fabs(sp) > 0.999) continue;
+
+        double roll = atan2(2.0 * (w * qx + qy * qz), 1.0 - 2.0 * (qx * qx + qy * qy)) * 180.0 / PI_D;
+        double pitch = asin(sp) * 180.0 / PI_D;
+        double yaw = atan2(2.0 * (w * qz + qx * qy), 1.0 - 2.0 * (qy * qy + qz * qz)) * 180.0 / PI_D;
+
+        float fr, fp, fy, fy_only;
+        FastMath_QuatToEuler((float)w, (float)qx, (float)qy, (float)qz, &fr, &fp, &fy);
+        FastMath_QuatToEuler((float)w, (float)qx, (float)qy, (float)qz, NULL, NULL, &fy_only);
+        CHECK(fy_only == fy);
+
+        // ±180°附近两边都算对
+        double dr = fabs(fr - roll), dy = fabs(fy - yaw);
+        if (dr > 180.0) dr = 360.0 - dr;
+        if (dy > 180.0) dy = 360.0 - dy;
+        err_euler = Max(err_euler, Max(dr, Max(dy, fabs(fp - pitch))));
+    }
+
+    printf("  atan2 %.3g rad, asin %.3g rad, sqrt/div rel %.3g, euler %.3g deg\n",
+           err_atan2, err_asin, err_rel, err_euler);
+    CHECK(err_atan2 <= FM_MAX_ERR_RAD);
+    CHECK(err_asin <= FM_MAX_ERR_RAD);
+    CHECK(err_rel <= FM_MAX_ERR_REL);
+    CHECK(err_euler <= FM_MAX_ERR_EULER);
+
+    return HOST_TEST_RESULT("test_fast_math");
+}
@@ -0,0 +1,60 @@
+/*
+ * test_heading.c
+ *
+ *  连续航向展开测试
+ *
+ *  不读陀螺仪，直接把模拟的yaw样本（折叠到±180°）送入Heading_Update：
+ *  先逆时针转HEADING_TEST_LAPS圈，再顺时针转回并多转半圈，逐点比较连续航向与实际累计角度，
+ *  并检查Heading_Error在边界两侧取最短路径、Heading_Wrap180的范围和复位后的状态。
+ */
+
+#include "host_test.h"
+#include "heading.h"
+
+#define HEADING_TEST_STEP       7.3f        // 每个模拟样本转过的角度（度）
+#define HEADING_TEST_LAPS       5           // 每个方向模拟的圈数
+#define HEADING_TEST_MAX_DIFF   0.01f       // 连续航向允许的最大偏差（度）
+
+int main(void)
+{
+    float truth = 170.0f;               // 从靠近边界处开始
+    float max_diff = 0.0f;
+    int steps = (int)(HEADING_TEST_LAPS * 360.0f / HEADING_TEST_STEP);
+
+    Heading_Reset();
+    CHECK(!Heading_IsValid());
+
+    for (int dir = 1; dir >= -1; dir -= 2) {
+        for (int i = 0; i <= steps + (dir < 0 ? steps + 25 : 0); i++) {
+            Heading_Update(Heading_Wrap180(truth));
+            float diff = fabsf(Heading_Get() - truth);
+            if (diff > max_diff) max_diff = diff;
+            truth += dir * HEADING_TEST_STEP;
+        }
+    }
+    printf("  max diff %.6f deg, final heading %.2f deg\n", max_diff, Heading_Get());
+    CHECK(Heading_IsValid());
+    CHECK(max_diff < HEADING_TEST_MAX_DIFF);
+
+    // 最短路径误差
+    CHECK_NEAR(Heading_Error(-170.0f, 170.0f), 20.0f, 0.001f);      // 跨+180逆时针20°
+    CHECK_NEAR(Heading_Error(170.0f, -170.0f), -20.0f, 0.001f);     // 跨-180顺时针20°
+    CHECK_NEAR(Heading_Error(725.0f, 0.0f), 5.0f, 0.001f);          // 连续航向目标
+    CHECK_NEAR(Heading_Error(0.0f, -1085.0f), 5.0f, 0.001f);        // 多圈后的连续航向
+
+    // 折叠范围[-180, 180)
+    for (float a = -1000.0f; a < 1000.0f; a += 13.7f) {
+        float w = Heading_Wrap180(a);
+        float laps = (a - w) / 360.0f;      // 只差整数圈
+        CHECK(w >= -180.0f && w < 180.0f);
+        CHECK_NEAR(laps, roundf(laps), 1e-4f);
+    }
+
+    // 复位后从新的样本重新开始，不带上次的圈数
+    Heading_Reset();
+    CHECK(!Heading_IsValid());
+    Heading_Update(-90.0f);
+    CHECK_NEAR(Heading_Get(), -90.0f, 0.001f);
+
+    return HOST_TEST_RESULT("test_heading");
+}
@@ -0,0 +1,107 @@
+/*
+ * test_ilc.c
+ *
+ *  迭代学习前馈收敛测试
+ *
+ *  编码器计数和标定后的每脉冲里程由测试直接给出（打桩Encoder_GetCount、MotorControl_GetMmPerPulse）。
+ *  每圈沿一段直线以固定步长前进，线位置误差 = 与位置相关的固定扰动 + 上一周期施加的前馈（车体响应简化为一个周期的延迟）。
+ *  检查误差RMS逐圈下降并收敛到理论稳态（遗忘因子决定残差），前馈不超过限幅，
+ *  段外和未开启学习时不施加前馈。
+ */
+
+#include "host_test.h"
+#include "ilc.h"
+#include "Encoder.h"
+#include "motor_control.h"
+
+#define MM_PER_PULSE    (MOTOR_MM_PER_PULSE_NOMINAL * 1.05f)   // 标定后的每脉冲里程（与名义值不同）
+#define STEP_MM         2.0f                    // 每个控制周期前进的距离
+#define TRACK_MM        (ILC_BINS * ILC_BIN_MM) // 表格覆盖的长度
+#define LAPS            30
+#define PI_F            3.14159265f
+
+static int32_t encoder_count;
+
+int32_t Encoder_GetCount(uint8_t motor_id)
+{
+    (void)motor_id;
+    return encoder_count;
+}
+
+float MotorControl_GetMmPerPulse(void)
+{
+    return MM_PER_PULSE;
+}
+
+// 与位置相关的固定扰动（线位置单位），每圈相同
+static float Disturbance(float x_mm, float amp)
+{
+    return amp * sinf(2.0f * PI_F * x_mm / 400.0f);
+}
+
+/**
+ * @brief 跑一圈（一段直线），返回误差RMS；max_ff输出本圈施加的最大前馈
+ */
+static float Run_Lap(float amp, float *max_ff)
+{
+    float sum = 0.0f, ff = 0.0f;
+    int n = 0;
+
+    encoder_count = 0;
+    ILC_BeginSegment(0);
+    *max_ff = 0.0f;
+    for (float x = 0.0f; x < TRACK_MM; x += STEP_MM) {
+        encoder_count = (int32_t)(x / MM_PER_PULSE);
+        // 上一周期施加的前馈本周期才体现在线位置上
+        float e = Disturbance(x, amp) + ff;
+        ff = Q16_TO_FLOAT(ILC_Step(Q16_FROM_FLOAT(e)));
+        if (fabsf(ff) > *max_ff) *max_ff = fabsf(ff);
+        sum += e * e;
+        n++;
+    }
+    ILC_EndSegment();
+    ILC_EndLap();
+    return sqrtf(sum / n);
+}
+
+int main(void)
+{
+    float rms[LAPS], max_ff;
+
+    // 小扰动：前馈不饱和，逐圈收敛
+    ILC_Init();
+    for (int k = 0; k < LAPS; k++) {
+        rms[k] = Run_Lap(5.0f, &max_ff);
+        if (k > 0) CHECK(rms[k] <= rms[k - 1] + 1e-3f);
+    }
+    // 稳态 e* = d·(1 - FORGET) / (1 - FORGET + LEARN_GAIN)，格内平均带来少量额外残差
+    float ratio = (1.0f - ILC_FORGET) / (1.0f - ILC_FORGET + ILC_LEARN_GAIN);
+    printf("  rms lap0 %.3f -> lap%d %.3f (steady-state ratio %.3f)\n", rms[0], LAPS - 1, rms[LAPS - 1], ratio);
+    CHECK(rms[LAPS - 1] < rms[0] * (ratio + 0.1f));
+    CHECK(max_ff <= ILC_FF_LIMIT + 0.01f);
+
+    // 大扰动：前馈被限幅
+    ILC_Init();
+    for (int k = 0; k < LAPS; k++) {
+        Run_Lap(30.0f, &max_ff);
+        CHECK(max_ff <= ILC_FF_LIMIT + 0.01f);
+    }
+    CHECK_NEAR(max_ff, ILC_FF_LIMIT, 0.05f);
+
+    // 未开启学习或超出表格：不施加前馈
+    ILC_EndSegment();
+    CHECK(ILC_Step(Q16_FROM_INT(5)) == 0);
+    encoder_count = 0;
+    ILC_BeginSegment(0);
+    // 分格按标定后的里程：末格之前10mm落在最后一格
+    encoder_count = (int32_t)((TRACK_MM - 10.0f) / MM_PER_PULSE);
+    ILC_Step(0);
+    CHECK(g_ilc.bin == ILC_BINS - 1);
+    encoder_count = (int32_t)((TRACK_MM + 10.0f) / MM_PER_PULSE);
+    CHECK(ILC_Step(Q16_FROM_INT(5)) == 0);
+    ILC_EndSegment();
+    ILC_BeginSegment(ILC_MAX_SEGMENTS);
+    CHECK(!g_ilc.active);
+
+    return HOST_TEST_RESULT("test_ilc");
+}
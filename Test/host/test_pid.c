@@ -0,0 +1,83 @@
+/*
+ * test_pid.c
+ *
+ *  浮点/定点PID等效性测试
+ *
+ *  用相同的目标/反馈序列（小幅正弦、阶跃、伪随机大误差）分别驱动PID_Calculate和PID_Q16_Calculate，
+ *  参数与motor_control.c中的循迹、Yaw、速度环一致，检查输出最大偏差、输出限幅和积分限幅。
+ */
+
+#include "host_test.h"
+#include "pid.h"
+#include <stdint.h>
+
+#define PID_EQ_STEPS        2000        // 每组参数的误差序列长度
+#define PID_EQ_MAX_DIFF     0.01f       // 允许的最大输出偏差（输出单位）
+
+// 与motor_control.c一致的参数：{Kp, Ki, Kd, 积分限幅, 输出限幅, 信号幅度}
+static const float params[][6] = {
+    {1.2f,  0.0f,  0.6f,   100.0f, 20.0f,  30.0f},     // 循迹（线位置±30）
+    {0.14f, 0.0f,  0.028f, 200.0f, 14.0f,  180.0f},    // Yaw（航向误差±180°）
+    {8.56f, 1.43f, 0.71f,  7.0f,   100.0f, 6.3f},      // 速度环（mm/s）
+};
+
+/**
+ * @brief 用同一序列驱动两种引擎，返回输出的最大偏差
+ */
+static float Run_Sequence(const float *p)
+{
+    PID_Controller_t pid_f;
+    PID_Controller_q16_t pid_q;
+    uint32_t seed = 1;
+    float max_diff = 0.0f;
+    float amp = p[5];
+
+    PID_Init(&pid_f, p[0], p[1], p[2], p[3], p[4]);
+    PID_Q16_Init(&pid_q, p[0], p[1], p[2], p[3], p[4]);
+
+    for (int k = 0; k < PID_EQ_STEPS; k++) {
+        float target = (k < 500) ? 0.0f : ((k < 1000) ? amp : amp * 0.5f);
+        float actual;
+        if (k < 500) {
+            actual = amp * sinf(k * 0.05f);             // 小幅正弦，检验比例/微分项
+        } else {
+            seed = seed * 1103515245u + 12345u;          // 大幅伪随机，检验积分限幅和抗饱和
+            actual = amp * ((float)((seed >> 16) % 2001) / 1000.0f - 1.0f) * 3.0f;
+        }
+
+        // 定点引擎的设定值和反馈直接以Q16给出（与控制中断中的用法相同）
+        q16_t target_q = Q16_FROM_FLOAT(target);
+        q16_t actual_q = Q16_FROM_FLOAT(actual);
+
+        PID_SetTarget(&pid_f, Q16_TO_FLOAT(target_q));
+        PID_Q16_SetTarget(&pid_q, target_q);
+        float out_f = PID_Calculate(&pid_f, Q16_TO_FLOAT(actual_q));
+        q16_t out_q = PID_Q16_Calculate(&pid_q, actual_q);
+
+        float diff = fabsf(out_f - Q16_TO_FLOAT(out_q));
+        if (diff > max_diff) max_diff = diff;
+
+        CHECK(out_q <= pid_q.output_limit && out_q >= -pid_q.output_limit);
+        CHECK(pid_q.integral <= pid_q.integral_limit && pid_q.integral >= -pid_q.integral_limit);
+    }
+    return max_diff;
+}
+
+int main(void)
+{
+    for (unsigned i = 0; i < sizeof(params) / sizeof(params[0]); i++) {
+        float diff = Run_Sequence(params[i]);
+        printf("  set %u: max diff %.6f\n", i, diff);
+        CHECK(diff <= PID_EQ_MAX_DIFF);
+    }
+
+    // 复位后两种引擎回到同一起点
+    PID_Controller_q16_t pid_q;
+    PID_Q16_Init(&pid_q, 1.0f, 1.0f, 1.0f, 10.0f, 10.0f);
+    PID_Q16_SetTarget(&pid_q, Q16_FROM_INT(5));
+    PID_Q16_Calculate(&pid_q, 0);
+    PID_Q16_Reset(&pid_q);
+    CHECK(pid_q.integral == 0 && pid_q.last_error == 0 && pid_q.output == 0);
+
+    return HOST_TEST_RESULT("test_pid");
+}
@@ -0,0 +1,98 @@
+/*
+ * test_setpoint.c
+ *
+ *  设定值规划器测试
+ *
+ *  用motor_control.c的速度规划参数（加速度、加加速度、10ms周期）驱动Setpoint_Step，
+ *  对阶跃、短距离、中途反向几种目标序列检查：不越过目标、变化率不超过加速度上限、
+ *  变化率每周期的改变不超过加加速度上限（到达目标的那一步除外），并在预期时间内到达目标。
+ */
+
+#include "host_test.h"
+#include "pid.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SP_ACCEL            12.6f       // 与MOTOR_PROFILE_ACCEL一致
+#define SP_JERK             84.0f       // 与MOTOR_PROFILE_JERK一致
+#define SP_PERIOD           0.01f       // 控制周期（s）
+#define SP_MAX_STEPS        1000
+
+/**
+ * @brief 从start向target规划，返回到达所用周期数（未到达返回-1）
+ * @param reverse_at 第几个周期把目标改为-target（<0表示不改）
+ */
+static int Run_Move(float accel, float jerk, float start, float target, int reverse_at)
+{
+    Setpoint_q16_t sp;
+    q16_t goal = Q16_FROM_FLOAT(target);
+    q16_t last_rate = 0;
+    bool reversed = false;
+
+    Setpoint_Init(&sp, accel, jerk, SP_PERIOD);
+    Setpoint_Reset(&sp, Q16_FROM_FLOAT(start));
+
+    for (int k = 0; k < SP_MAX_STEPS; k++) {
+        if (k == reverse_at) {
+            goal = -goal;
+            reversed = true;
+        }
+        q16_t prev = sp.value;
+        q16_t value = Setpoint_Step(&sp, goal);
+        q16_t delta = value - prev;
+
+        // 变化率不超过加速度上限
+        CHECK(delta <= sp.rate_max && delta >= -sp.rate_max);
+        if (value == goal) {
+            return k + 1;
+        }
+        // 未反向时单调逼近目标、不越过目标
+        if (!reversed) {
+            CHECK(goal >= Q16_FROM_FLOAT(start) ? (value >= prev && value < goal)
+                                               : (value <= prev && value > goal));
+        }
+        // S形：变化率每周期的改变不超过jerk
+        if (sp.jerk != 0) {
+            q16_t dj = delta - last_rate;
+            CHECK(dj <= sp.jerk && dj >= -sp.jerk);
+        }
+        last_rate = delta;
+    }
+    return -1;
+}
+
+int main(void)
+{
+    // 理想S形用时：距离/加速度 + 加速度/加加速度（达到加速度上限时）
+    float t_full = 6.3f / SP_ACCEL + SP_ACCEL / SP_JERK;
+    int n;
+
+    n = Run_Move(SP_ACCEL, SP_JERK, 0.0f, 6.3f, -1);
+    printf("  0 -> 6.3: %d steps (ideal %.0f)\n", n, t_full / SP_PERIOD);
+    CHECK(n > 0 && n <= (int)(t_full / SP_PERIOD * 1.2f) + 2);
+
+    n = Run_Move(SP_ACCEL, SP_JERK, 6.3f, 0.0f, -1);
+    CHECK(n > 0 && n <= (int)(t_full / SP_PERIOD * 1.2f) + 2);
+
+    // 短距离：来不及到加速度上限（三角形变化率）
+    n = Run_Move(SP_ACCEL, SP_JERK, 0.0f, -0.1f, -1);
+    float t_short = 2.0f * sqrtf(0.1f / SP_JERK);
+    printf("  0 -> -0.1: %d steps (ideal %.0f)\n", n, t_short / SP_PERIOD);
+    CHECK(n > 0 && n <= (int)(t_short / SP_PERIOD * 1.3f) + 2);
+
+    // 中途反向：限幅仍然成立，最终到达新目标
+    n = Run_Move(SP_ACCEL, SP_JERK, 0.0f, 6.3f, 20);
+    CHECK(n > 20);
+
+    // 梯形（jerk为0）：每周期变化量取上限，按距离/上限的周期数到达
+    n = Run_Move(SP_ACCEL, 0.0f, 0.0f, 6.3f, -1);
+    CHECK(n == (int)(6.3f / (SP_ACCEL * SP_PERIOD) + 0.999f));
+
+    // 已在目标：保持不动
+    Setpoint_q16_t sp;
+    Setpoint_Init(&sp, SP_ACCEL, SP_JERK, SP_PERIOD);
+    Setpoint_Reset(&sp, Q16_FROM_INT(3));
+    CHECK(Setpoint_Step(&sp, Q16_FROM_INT(3)) == Q16_FROM_INT(3) && sp.rate == 0);
+
+    return HOST_TEST_RESULT("test_setpoint");
+}
@@ -0,0 +1,111 @@
+/*
+ * test_track_map.c
+ *
+ *  赛道地图速度规划测试
+ *
+ *  编码器计数和标定后的每脉冲里程由测试直接给出（打桩Encoder_GetCount、MotorControl_GetMmPerPulse），
+ *  模拟一圈学习、一圈补测第一段、之后按地图行驶：
+ *  检查加速段满足 v² = v_c² + 2·ACCEL·d、减速段满足 v² = v_c² + 2·BRAKE·(剩余 - 余量)，
+ *  路口前余量处降到过弯速度，全程不超过v_max，路口类型不符时地图作废。
+ */
+
+#include "host_test.h"
+#include "track_map.h"
+#include "Encoder.h"
+#include "motor_control.h"
+
+#define V_MAX       6.3f
+#define V_CORNER    4.2f
+#define SEG_MM      1000.0f                             // 每段直线长度
+#define MM_PER_PULSE (MOTOR_MM_PER_PULSE_NOMINAL * 1.05f)   // 标定后的每脉冲里程（与名义值不同）
+#define MM(p)       ((int32_t)((p) / MM_PER_PULSE))     // 毫米换算为脉冲
+
+static int32_t encoder_count;
+
+int32_t Encoder_GetCount(uint8_t motor_id)
+{
+    (void)motor_id;
+    return encoder_count;
+}
+
+float MotorControl_GetMmPerPulse(void)
+{
+    return MM_PER_PULSE;
+}
+
+// 行驶一段直线并在段末确认左转路口
+static void Drive_Segment(float length_mm)
+{
+    TrackMap_StartSegment();
+    encoder_count += MM(length_mm);
+    TrackMap_MarkCorner(JUNCTION_LEFT);
+}
+
+int main(void)
+{
+    encoder_count = 0;
+    TrackMap_Init();
+    CHECK(TrackMap_GetSpeed(V_MAX, V_CORNER) == V_MAX);        // 没有地图：恒速
+
+    // 学习圈：从出发点开始（第一段不完整），4段
+    TrackMap_StartLearning();
+    TrackMap_BeginLap();
+    CHECK(TrackMap_GetSpeed(V_MAX, V_CORNER) == V_CORNER);
+    Drive_Segment(SEG_MM * 0.5f);
+    for (int i = 0; i < 3; i++) Drive_Segment(SEG_MM);
+    TrackMap_EndLap();
+    CHECK(g_trackMap.state == TRACK_MAP_READY && g_trackMap.count == 4);
+    CHECK(g_trackMap.seg[0].partial && !g_trackMap.seg[1].partial);
+
+    // 第二圈：第一段长度未知，按过弯速度行驶并补测
+    TrackMap_BeginLap();
+    TrackMap_StartSegment();
+    CHECK(TrackMap_GetSpeed(V_MAX, V_CORNER) == V_CORNER);
+    encoder_count += MM(SEG_MM);
+    TrackMap_MarkCorner(JUNCTION_LEFT);
+    CHECK(!g_trackMap.seg[0].partial);
+    CHECK_NEAR(g_trackMap.seg[0].length * MM_PER_PULSE, SEG_MM, 1.0f);
+    for (int i = 0; i < 3; i++) Drive_Segment(SEG_MM);
+    TrackMap_EndLap();
+
+    // 第三圈第一段：逐毫米检查速度曲线
+    TrackMap_BeginLap();
+    TrackMap_StartSegment();
+    int32_t start = encoder_count;
+    float v_prev = 0.0f, v_peak = 0.0f;
+    int braking = 0;
+    for (float d = 0.0f; d <= SEG_MM; d += 1.0f) {
+        encoder_count = start + MM(d);
+        float travelled = TrackMap_GetSegmentDistance();
+        float remaining = g_trackMap.seg[0].length * MM_PER_PULSE - travelled - TRACK_MAP_BRAKE_MARGIN_MM;
+        if (remaining < 0.0f) remaining = 0.0f;
+        float v = TrackMap_GetSpeed(V_MAX, V_CORNER);
+
+        float v_acc = sqrtf(V_CORNER * V_CORNER + 2.0f * TRACK_MAP_ACCEL_MMPS2 * travelled);
+        float v_brk = sqrtf(V_CORNER * V_CORNER + 2.0f * TRACK_MAP_BRAKE_MMPS2 * remaining);
+        float v_ref = fminf(V_MAX, fminf(v_acc, v_brk));
+        CHECK_NEAR(v, v_ref, 1e-4f);
+        CHECK(v >= V_CORNER - 1e-4f && v <= V_MAX);
+
+        // 先不减后不增（单峰）
+        if (v < v_prev - 1e-5f) braking = 1;
+        if (braking) CHECK(v <= v_prev + 1e-5f);
+        if (v > v_peak) v_peak = v;
+        v_prev = v;
+    }
+    printf("  peak %.3f mm/s, speed at junction %.3f mm/s\n", v_peak, v_prev);
+    CHECK_NEAR(v_peak, V_MAX, 1e-4f);                           // 1000mm足够加到最高速
+    CHECK_NEAR(v_prev, V_CORNER, 1e-4f);                        // 路口前降到过弯速度
+
+    // 加速段长度为 (v_max² - v_c²) / (2·ACCEL)，走到一半时还没到最高速
+    encoder_count = start + MM((V_MAX * V_MAX - V_CORNER * V_CORNER) / (2.0f * TRACK_MAP_ACCEL_MMPS2) * 0.5f);
+    CHECK(TrackMap_GetSpeed(V_MAX, V_CORNER) < V_MAX);
+
+    // 路口类型与地图不符：地图作废，回到恒速
+    encoder_count = start + MM(SEG_MM);
+    TrackMap_MarkCorner(JUNCTION_RIGHT);
+    CHECK(g_trackMap.state == TRACK_MAP_EMPTY);
+    CHECK(TrackMap_GetSpeed(V_MAX, V_CORNER) == V_MAX);
+
+    return HOST_TEST_RESULT("test_track_map");
+}
@@ -4,34 +4,64 @@
  *  模块化测试代码
  */
 #include "test.h"
-#include "oled_hardware_i2c.h"
+#include "oled.h"
 #include "mpu6050.h"
 #include "motor_control.h"
 #include "Encoder.h"
 #include "clock.h"
 #include "linetracker.h"
 #include "turn_detection.h"
-#include <stdio.h>
+#include "fast_math.h"
+#include "heading.h"
+#include "track_map.h"
+#include "ilc.h"
 #include <string.h>
 #include <math.h>
 
-// 用于在OLED上显示调试信息
-char oled_buffer[40];
 
-
-#define SQUARE_LINE_SPEED 45.0f       // 正方形直线行驶速度
-#define SQUARE_TURN_SPEED 4.0f       // 原地转弯速度
+#define SQUARE_LINE_SPEED 6.3f        // 正方形直线行驶速度（mm/s，原45PPS）
+#define SQUARE_CORNER_SPEED 4.2f      // 多圈时学习圈速度和入弯速度（mm/s，原30PPS；按地图规划时直线加速到SQUARE_LINE_SPEED）
+#define SQUARE_TURN_SPEED 0.56f       // 原地转弯速度（mm/s，原4PPS）
 #define SQUARE_TURN_SETTLE_MS 50      // 转弯完成后稳定时间（从200ms减少到50ms）
 #define SQUARE_TURN_PRECISION 3.0f    // 转弯精度（度）
 #define SQUARE_TURN_TIMEOUT_MS 1000   // 转弯 超时时间（毫秒）
+#define SQUARE_TURN_RATE 3.5f         // 陀螺仪闭环转弯最大角速度（deg/s），轮速约4.9mm/s，低于MAX_MOTOR_SPEED留出修正余量
+#define SQUARE_CORNER_ARC 1           // 1=不停车圆弧过弯，0=停车后原地转向
+
+// 本圈是否从上一圈最后一个弯出来开始（第一圈从出发点开始，第一段位置和之后各圈不一致，不做迭代学习）
+static bool square_lap_from_corner = false;
+
+/**
+ * @brief 开始一段直线：赛道地图计里程，迭代学习按段号记录
+ * @param side 本圈的边号（0-3）
+ */
+static void Square_BeginSide(uint8_t side)
+{
+    TrackMap_StartSegment();
+    if (side > 0 || square_lap_from_corner) {
+        ILC_BeginSegment(side);
+    }
+}
 
 /**
  * @brief 执行基于循迹传感器反馈的转向
  * @param direction 转向方向（1=左转，-1=右转）
  * @return 转向结果（0=成功，-1=超时）
+ * @note 有航向数据时用MotorControl_TurnBy按陀螺仪闭环转90°（梯形角速度规划，末段循迹传感器捕获线），
+ *       否则退回原来的恒速旋转直到中间传感器看到线
  */
 static int PerformSensorBasedTurn(int direction) {
     uint32_t turn_start_time = tick_ms;
+
+    if (Heading_IsValid()) {
+        MotorControl_SetTurnCapture(true);
+        MotorControl_TurnBy(direction > 0 ? 90.0f : -90.0f, SQUARE_TURN_RATE);
+        while (MotorControl_GetTurnStatus() == MOTOR_TURN_BUSY) {
+            MPU6050_Service();
+            delay_ms(10);
+        }
+        return (MotorControl_GetTurnStatus() == MOTOR_TURN_DONE) ? 0 : -1;
+    }
     
     // 设置转向模式：实现差速转向，一侧车轮正转，另一侧车轮反转
     MotorControl_SetMode(MOTOR_MODE_SPEED_CONTROL);
@@ -46,11 +76,12 @@ static int PerformSensorBasedTurn(int direction) {
     
     // 等待中间传感器检测到线或者超时
     while (1) {
-        // 更新传感器数据
-        LineTracker_ReadSensors();
+        // 获取传感器数据快照（采样在TIMG8中断中进行）
+        LineTracker_t line;
+        LineTracker_GetSnapshot(&line);
         
         // 检查中间传感器是否检测到线（表示转向完成）
-        if (g_lineTracker.sensorValue[2] && g_lineTracker.sensorValue[3]) {  // 传感器2和3同时检测到线才表示转向完成
+        if (line.sensorValue[2] && line.sensorValue[3]) {  // 传感器2和3同时检测到线才表示转向完成
             MotorControl_SetMode(MOTOR_MODE_STOP);
             return 0; // 成功
         }
@@ -72,10 +103,10 @@ static int PerformSensorBasedTurn(int direction) {
  * 
  * 执行流程：
  * 1. 7路循迹直线行驶
- * 2. 检测到左侧转弯信号立即停车
- * 3. 使用循迹传感器反馈进行转向，直到中间传感器检测到线
- * 4. 等待稳定后继续直线行驶
- * 5. 重复4次后停止（一圈正方形）
+ * 2. 检测到转弯路口（左/右/T字）：
+ *    SQUARE_CORNER_ARC=1时不停车，按路口位置和当前速度规划圆弧过弯，出弯后直接回到循迹；
+ *    否则立即停车，使用循迹传感器反馈原地转向，直到中间传感器检测到线，等待稳定后继续
+ * 3. 重复4次后停止（一圈正方形），OLED显示本圈用时
  */
 void Test_Square_Movement_Hybrid(void)
 {
@@ -86,6 +117,7 @@ void Test_Square_Movement_Hybrid(void)
     // 状态变量
     typedef enum {
         SQUARE_STATE_LINE_FOLLOWING,    // 直线巡线状态
+        SQUARE_STATE_CORNERING,         // 圆弧过弯状态
         SQUARE_STATE_SETTLING,          // 转弯后稳定状态
         SQUARE_STATE_COMPLETED          // 完成状态
     } Square_State_t;
@@ -93,40 +125,82 @@ void Test_Square_Movement_Hybrid(void)
     Square_State_t current_state = SQUARE_STATE_LINE_FOLLOWING;
     uint8_t completed_sides = 0;        // 已完成的边数
     uint32_t settle_start_time = 0;     // 稳定阶段开始时间
+    uint32_t lap_start_time = tick_ms;  // 本圈开始时间
     
-    // 设置初始循迹模式
-    MotorControl_SetBaseSpeed(SQUARE_LINE_SPEED);
+    // 设置初始循迹模式（速度由赛道地图给出，没有地图时为SQUARE_LINE_SPEED）
+    TrackMap_BeginLap();
+    Square_BeginSide(0);
+    MotorControl_SetBaseSpeed(TrackMap_GetSpeed(SQUARE_LINE_SPEED, SQUARE_CORNER_SPEED));
     MotorControl_SetMode(MOTOR_MODE_LINE_FOLLOWING);
     
     while(1) {
+        // 陀螺仪读取链超时恢复和FIFO复位（访问总线，不能放在控制中断里）
+        MPU6050_Service();
+
         switch(current_state) {
             case SQUARE_STATE_LINE_FOLLOWING:
             {
                 // 直线巡线状态
                 
-                // 检查是否检测到转弯
+                // 检查是否检测到转弯（圆弧过弯等分类确认，按确认点推算转角位置；
+                // 停车转向在分支信号一出现就停车，与原来的停车位置一致）
+#if SQUARE_CORNER_ARC
+                if (TurnDetection_IsTurnConfirmed()) {
+                    TrackMap_MarkCorner(TurnDetection_GetTurnType());
+                    ILC_EndSegment();
+                    // 不停车圆弧过弯（T字路口默认左转）
+                    MotorControl_StartCorner(TurnDetection_GetTurnType() == JUNCTION_RIGHT ? -90.0f : 90.0f,
+                                             TurnDetection_GetTurnOvershoot());
+                    TurnDetection_Reset();
+                    current_state = SQUARE_STATE_CORNERING;
+                } else
+#else
                 if (TurnDetection_IsTurnReady()) {
+                    TrackMap_MarkCorner(TurnDetection_GetTurnType());
+                    ILC_EndSegment();
                     // 立即停车并执行转向
                     MotorControl_SetMode(MOTOR_MODE_STOP);
                     delay_ms(50); // 短暂暂停确保停车，从100ms减少到20ms以提高响应速度
                     
-                    // 执行基于传感器反馈的左转
-                    int turn_result = PerformSensorBasedTurn(1); // 1表示左转
+                    // 按检测到的路口方向转向（T字路口默认左转）
+                    int turn_result = PerformSensorBasedTurn(
+                        TurnDetection_GetTurnType() == JUNCTION_RIGHT ? -1 : 1);
                     
                     // 重置转弯检测状态
                     TurnDetection_Reset();
                     
                     settle_start_time = tick_ms;
                     current_state = SQUARE_STATE_SETTLING;
-                } else {
+                } else
+#endif
+                {
+                    // 按地图规划速度：出弯加速，接近已知路口时减速
+                    MotorControl_SetBaseSpeed(TrackMap_GetSpeed(SQUARE_LINE_SPEED, SQUARE_CORNER_SPEED));
+
                     // 正常直线巡线 - 简化显示
                     OLED_ShowString(0, 0, (uint8_t*)"Running...", 16);
-                    sprintf(oled_buffer, "Side: %d/4", completed_sides + 1);
-                    OLED_ShowString(0, 2, (uint8_t*)oled_buffer, 16);
+                    uint8_t x = OLED_ShowString(0, 2, (uint8_t*)"Side: ", 16);
+                    x = OLED_ShowInt(x, 2, completed_sides + 1, 0, 16);
+                    OLED_ShowString(x, 2, (uint8_t*)"/4", 16);
                 }
                 break;
             }
             
+            case SQUARE_STATE_CORNERING:
+            {
+                // 圆弧过弯状态，出弯后电机控制已自动回到循迹模式，直接计入一条边
+                if (!MotorControl_IsCornering()) {
+                    completed_sides++;
+                    if (completed_sides >= 4) {
+                        current_state = SQUARE_STATE_COMPLETED;
+                    } else {
+                        Square_BeginSide(completed_sides);
+                        current_state = SQUARE_STATE_LINE_FOLLOWING;
+                    }
+                }
+                break;
+            }
+
             case SQUARE_STATE_SETTLING:
             {
                 // 转弯后稳定状态
@@ -141,7 +215,8 @@ void Test_Square_Movement_Hybrid(void)
                     }
                     else {
                         // 继续下一边
-                        MotorControl_SetBaseSpeed(SQUARE_LINE_SPEED);
+                        Square_BeginSide(completed_sides);
+                        MotorControl_SetBaseSpeed(TrackMap_GetSpeed(SQUARE_LINE_SPEED, SQUARE_CORNER_SPEED));
                         MotorControl_SetMode(MOTOR_MODE_LINE_FOLLOWING);
                         current_state = SQUARE_STATE_LINE_FOLLOWING;
                     }
@@ -151,20 +226,23 @@ void Test_Square_Movement_Hybrid(void)
             
             case SQUARE_STATE_COMPLETED:
             {
-                // 完成状态
+                // 完成状态，显示本圈用时
                 MotorControl_SetMode(MOTOR_MODE_STOP);
+                TrackMap_EndLap();
+                ILC_EndLap();
+                uint8_t x = OLED_ShowString(0, 4, (uint8_t*)"Lap:", 16);
+                x = OLED_ShowInt(x, 4, (int32_t)(tick_ms - lap_start_time), 0, 16);
+                OLED_ShowString(x, 4, (uint8_t*)"ms", 16);
                 return; // 函数结束
             }
         }
         
         // 显示传感器状态（底部，仅在非完成状态）
         if (current_state != SQUARE_STATE_COMPLETED) {
-            sprintf(oled_buffer, "S:%d%d%d%d%d%d%d",
-                    g_lineTracker.sensorValue[0], g_lineTracker.sensorValue[1],
-                    g_lineTracker.sensorValue[2], g_lineTracker.sensorValue[3],
-                    g_lineTracker.sensorValue[4], g_lineTracker.sensorValue[5],
-                    g_lineTracker.sensorValue[6]);
-            OLED_ShowString(0, 6, (uint8_t*)oled_buffer, 16);
+            LineTracker_t line;
+            LineTracker_GetSnapshot(&line);
+            uint8_t x = OLED_ShowString(0, 6, (uint8_t*)"S:", 16);
+            OLED_ShowBits(x, 6, line.sensorBits, LINE_SENSOR_COUNT, 16);
         }
         
         delay_ms(20); // 控制循环频率，提高响应速度
@@ -174,22 +252,39 @@ void Test_Square_Movement_Hybrid(void)
 /**
  * @brief 指定圈数的正方形循迹 - 基于循迹传感器反馈的转向控制
  * @param laps 正方形圈数 (1-5)
+ * @note 多于一圈时第一圈以SQUARE_CORNER_SPEED学习赛道地图，之后各圈按地图规划速度；
+ *       只跑一圈时不学习，恒速SQUARE_LINE_SPEED
  */
 void Test_Square_Movement_Hybrid_With_Laps(int laps) {
     // 确保laps在有效范围内
     if (laps < 1) laps = 1;
     if (laps > 5) laps = 5;
     
+    uint32_t start_time = tick_ms;
+
+    if (laps > 1) {
+        TrackMap_StartLearning();
+    } else {
+        TrackMap_Init();
+    }
+    ILC_Init();
+
     // Test_Square_Movement_Hybrid执行一次就是一圈(4条边)
     for (int i = 0; i < laps; i++) {
+        square_lap_from_corner = (i > 0);
         Test_Square_Movement_Hybrid();
     }
+    square_lap_from_corner = false;
+    uint32_t total_time = tick_ms - start_time;
     
-    // 完成所有圈数后显示完成信息
+    // 完成所有圈数后显示完成信息和总用时
     OLED_Clear();
-    sprintf(oled_buffer, "%d laps done!", laps);
-    OLED_ShowString(0, 2, (uint8_t*)oled_buffer, 16);
+    uint8_t x = OLED_ShowInt(0, 2, laps, 0, 16);
+    OLED_ShowString(x, 2, (uint8_t*)" laps done!", 16);
     OLED_ShowString(0, 4, (uint8_t*)"Press key exit", 16);
+    x = OLED_ShowString(0, 6, (uint8_t*)"T:", 16);
+    x = OLED_ShowInt(x, 6, (int32_t)total_time, 0, 16);
+    OLED_ShowString(x, 6, (uint8_t*)"ms", 16);
     
     // 等待按键退出
     while(1) {
@@ -216,8 +311,8 @@ void Test_Square_Movement_Hybrid_Key_Control(void) {
     // 显示初始界面
     OLED_Clear();
     OLED_ShowString(0, 0, (uint8_t*)"Set laps:", 16);
-    sprintf(oled_buffer, "Laps: %d (1-5)", laps);
-    OLED_ShowString(0, 2, (uint8_t*)oled_buffer, 16);
+    OLED_ShowString(0, 2, (uint8_t*)"Laps:   (1-5)", 16);
+    OLED_ShowInt(48, 2, laps, 0, 16);
     OLED_ShowString(0, 4, (uint8_t*)"Key1:+ Key2:-", 16);
     OLED_ShowString(0, 6, (uint8_t*)"Key3:Start", 16);
     
@@ -230,8 +325,7 @@ void Test_Square_Movement_Hybrid_Key_Control(void) {
                 while (!DL_GPIO_readPins(GPIOA, DL_GPIO_PIN_23)); // 等待按键释放
                 laps++;
                 if (laps > 5) laps = 5;
-                sprintf(oled_buffer, "Laps: %d (1-5)", laps);
-                OLED_ShowString(0, 2, (uint8_t*)oled_buffer, 16);
+                OLED_ShowInt(48, 2, laps, 0, 16);
             }
         }
         
@@ -242,8 +336,7 @@ void Test_Square_Movement_Hybrid_Key_Control(void) {
                 while (!DL_GPIO_readPins(GPIOA, DL_GPIO_PIN_21)); // 等待按键释放
                 laps--;
                 if (laps < 1) laps = 1;
-                sprintf(oled_buffer, "Laps: %d (1-5)", laps);
-                OLED_ShowString(0, 2, (uint8_t*)oled_buffer, 16);
+                OLED_ShowInt(48, 2, laps, 0, 16);
             }
         }
         
@@ -275,25 +368,21 @@ void Test_Line_Sensors_Debug(void) {
     OLED_Clear();
     
     while (1) {
-        // 读取传感器数据
-        LineTracker_ReadSensors();
+        // 读取传感器数据快照（采样在TIMG8中断中进行）
+        LineTracker_t line;
+        LineTracker_GetSnapshot(&line);
         
         // 显示传感器状态
         OLED_ShowString(0, 0, (uint8_t*)"Sensors:", 16);
-        sprintf(oled_buffer, "S1:%d S2:%d S3:%d", 
-                g_lineTracker.sensorValue[0],
-                g_lineTracker.sensorValue[1], 
-                g_lineTracker.sensorValue[2]);
-        OLED_ShowString(0, 2, (uint8_t*)oled_buffer, 16);
-        
-        sprintf(oled_buffer, "S4:%d S5:%d S6:%d", 
-                g_lineTracker.sensorValue[3],
-                g_lineTracker.sensorValue[4], 
-                g_lineTracker.sensorValue[5]);
-        OLED_ShowString(0, 4, (uint8_t*)oled_buffer, 16);
-        
-        sprintf(oled_buffer, "S7:%d", g_lineTracker.sensorValue[6]);
-        OLED_ShowString(0, 6, (uint8_t*)oled_buffer, 16);
+        // 每行3路："S1:x S2:x S3:x"，每项5个字符宽
+        for (int i = 0; i < LINE_SENSOR_COUNT; i++) {
+            uint8_t x = (i % 3) * 40;
+            uint8_t y = 2 + (i / 3) * 2;
+            x = OLED_ShowString(x, y, (uint8_t*)"S", 16);
+            x = OLED_ShowInt(x, y, i + 1, 0, 16);
+            x = OLED_ShowString(x, y, (uint8_t*)":", 16);
+            OLED_ShowInt(x, y, line.sensorValue[i], 0, 16);
+        }
         
         // 检查是否有按键按下退出
         if (!DL_GPIO_readPins(GPIOA, DL_GPIO_PIN_23) ||  // Key_1
@@ -319,3 +408,214 @@ void Test_Line_Sensors_Debug(void) {
     OLED_ShowString(0, 4, (uint8_t*)"Debug Test", 16);
     delay_ms(1000);
 }
+
+
+#define OLED_BENCH_FRAMES   20          // 测量的整屏刷新次数
+
+/**
+ * @brief OLED整屏刷新吞吐量测试
+ *
+ * 每帧把整个显存标记为脏后同步刷新（8页 x 128字节），用CPU周期计数统计耗时，
+ * 在屏幕上显示帧率和显存数据的有效位速率。软件I2C/SPI传输层没有硬件外设，
+ * 用它确认位操作快速路径能达到的刷新率；各传输层之间也可以直接比较。
+ *
+ * @return 有效位速率（bit/s，只计显存数据，不含定位命令、地址和应答位）
+ */
+uint32_t Test_OLED_Throughput(void) {
+    uint32_t start, cycles, bps, fps_x10;
+    uint8_t x;
+
+    OLED_Clear();
+    OLED_ShowString(0, 0, (uint8_t*)"OLED Bench", 16);
+
+    start = mspm0_get_clock_cycles();
+    for (int i = 0; i < OLED_BENCH_FRAMES; i++) {
+        OLED_Invalidate();
+        OLED_Refresh();
+    }
+    cycles = mspm0_get_clock_cycles() - start;
+    if (cycles == 0) cycles = 1;
+
+    bps = (uint32_t)((uint64_t)OLED_BENCH_FRAMES * OLED_PAGES * OLED_WIDTH * 8 * CPUCLK_FREQ / cycles);
+    fps_x10 = (uint32_t)((uint64_t)OLED_BENCH_FRAMES * 10 * CPUCLK_FREQ / cycles);
+
+    x = OLED_ShowString(0, 2, (uint8_t*)"FPS: ", 16);
+    OLED_ShowFixed(x, 2, (int32_t)fps_x10, 1, 0, 16);
+    x = OLED_ShowInt(0, 4, (int32_t)(bps / 1000), 0, 16);
+    OLED_ShowString(x, 4, (uint8_t*)" kbit/s", 16);
+    x = OLED_ShowInt(0, 6, (int32_t)((uint64_t)cycles * 1000000u / CPUCLK_FREQ / OLED_BENCH_FRAMES), 0, 16);
+    OLED_ShowString(x, 6, (uint8_t*)" us/frame", 16);
+
+    return bps;
+}
+
+
+#define FAST_MATH_BENCH_N       1000        // 每项测试的采样点数
+#define FAST_MATH_MAX_ERR_DEG   0.001f      // 允许的最大误差（度）
+#define FAST_MATH_MAX_ERR_REL   1e-5f       // 开方、除法允许的最大相对误差
+
+static volatile float fast_math_sink;       // 防止基准循环被优化掉
+
+/**
+ * @brief 快速三角函数精度与耗时测试
+ *
+ * atan2在整个圆周上均匀取点，asin在[-1, 1]上均匀取点，与libm的atan2f/asinf比较最大误差，
+ * 再用CPU周期计数分别统计两者每次调用的平均耗时。第一行显示最大误差（1/10000度），
+ * 第二、三行显示 快速/libm 每次调用的周期数。FastMath_Sqrt/FastMath_Div在宽动态范围内
+ * 检查相对误差，只计入通过判定。
+ *
+ * @return 0=通过，-1=误差超限
+ */
+int Test_FastMath_Accuracy(void) {
+    float err_atan2 = 0.0f, err_asin = 0.0f, err_rel = 0.0f;
+    uint32_t start, cyc_fast_atan2, cyc_libm_atan2, cyc_fast_asin, cyc_libm_asin;
+    uint8_t x;
+
+    // 精度
+    for (int i = 0; i < FAST_MATH_BENCH_N; i++) {
+        float a = -FAST_MATH_PI + 2.0f * FAST_MATH_PI * i / FAST_MATH_BENCH_N;
+        float c = cosf(a), s = sinf(a);
+        float e = fabsf(FastMath_Atan2(s, c) - atan2f(s, c)) * FAST_MATH_RAD2DEG;
+        if (e > err_atan2) err_atan2 = e;
+
+        s = -1.0f + 2.0f * i / (FAST_MATH_BENCH_N - 1);
+        e = fabsf(FastMath_Asin(s) - asinf(s)) * FAST_MATH_RAD2DEG;
+        if (e > err_asin) err_asin = e;
+
+        // 开方、除法：覆盖约2^-20 ~ 2^20的数量级
+        float v = ldexpf(1.0f + (float)i / FAST_MATH_BENCH_N, i % 41 - 20);
+        e = fabsf(FastMath_Sqrt(v) / sqrtf(v) - 1.0f);
+        if (e > err_rel) err_rel = e;
+        e = fabsf(FastMath_Div(c, v) * v / c - 1.0f);
+        if (c != 0.0f && e > err_rel) err_rel = e;
+    }
+
+    // 耗时（输入在循环内生成，两边开销相同）
+    start = mspm0_get_clock_cycles();
+    for (int i = 0; i < FAST_MATH_BENCH_N; i++) fast_math_sink = FastMath_Atan2((float)(i - 500), 300.0f);
+    cyc_fast_atan2 = (mspm0_get_clock_cycles() - start) / FAST_MATH_BENCH_N;
+
+    start = mspm0_get_clock_cycles();
+    for (int i = 0; i < FAST_MATH_BENCH_N; i++) fast_math_sink = atan2f((float)(i - 500), 300.0f);
+    cyc_libm_atan2 = (mspm0_get_clock_cycles() - start) / FAST_MATH_BENCH_N;
+
+    start = mspm0_get_clock_cycles();
+    for (int i = 0; i < FAST_MATH_BENCH_N; i++) fast_math_sink = FastMath_Asin((float)(i - 500) * 0.00199f);
+    cyc_fast_asin = (mspm0_get_clock_cycles() - start) / FAST_MATH_BENCH_N;
+
+    start = mspm0_get_clock_cycles();
+    for (int i = 0; i < FAST_MATH_BENCH_N; i++) fast_math_sink = asinf((float)(i - 500) * 0.00199f);
+    cyc_libm_asin = (mspm0_get_clock_cycles() - start) / FAST_MATH_BENCH_N;
+
+    int pass = (err_atan2 <= FAST_MATH_MAX_ERR_DEG) && (err_asin <= FAST_MATH_MAX_ERR_DEG) &&
+               (err_rel <= FAST_MATH_MAX_ERR_REL);
+
+    OLED_Clear();
+    x = OLED_ShowString(0, 0, (uint8_t*)"E:", 16);
+    x = OLED_ShowInt(x, 0, (int32_t)(err_atan2 * 10000.0f), 0, 16);
+    x = OLED_ShowString(x, 0, (uint8_t*)"/", 16);
+    OLED_ShowInt(x, 0, (int32_t)(err_asin * 10000.0f), 0, 16);
+    x = OLED_ShowString(0, 2, (uint8_t*)"atan2 ", 16);
+    x = OLED_ShowInt(x, 2, (int32_t)cyc_fast_atan2, 0, 16);
+    x = OLED_ShowString(x, 2, (uint8_t*)"/", 16);
+    OLED_ShowInt(x, 2, (int32_t)cyc_libm_atan2, 0, 16);
+    x = OLED_ShowString(0, 4, (uint8_t*)"asin  ", 16);
+    x = OLED_ShowInt(x, 4, (int32_t)cyc_fast_asin, 0, 16);
+    x = OLED_ShowString(x, 4, (uint8_t*)"/", 16);
+    OLED_ShowInt(x, 4, (int32_t)cyc_libm_asin, 0, 16);
+    OLED_ShowString(0, 6, (uint8_t*)(pass ? "PASS" : "FAIL"), 16);
+
+    return pass ? 0 : -1;
+}
+
+
+#define TEST_CAL_DISTANCE_MM    1000.0f     // 直线标定距离（mm，按卷尺推行）
+#define TEST_CAL_TURN_DEG       360.0f      // 轮距标定原地旋转角度（度）
+#define TEST_CAL_TURN_RATE      3.5f        // 轮距标定旋转角速度（deg/s，超过车轮能力时TurnBy按MotorControl_GetMaxTurnRate限幅）
+
+/**
+ * @brief 等待Key1按下并释放
+ */
+static void Test_Wait_Key1(void)
+{
+    while (1) {
+        if (!DL_GPIO_readPins(GPIOA, DL_GPIO_PIN_23)) {
+            delay_ms(20); // 消除抖动
+            if (!DL_GPIO_readPins(GPIOA, DL_GPIO_PIN_23)) {
+                while (!DL_GPIO_readPins(GPIOA, DL_GPIO_PIN_23)); // 等待按键释放
+                return;
+            }
+        }
+        delay_ms(10);
+    }
+}
+
+/**
+ * @brief 车轮里程与轮距标定
+ *
+ * 1. 直线标定：把车放在卷尺起点，按Key1后沿直线推行TEST_CAL_DISTANCE_MM，再按Key1，
+ *    按两轮编码器计数计算每轮标定系数（同时补偿轮径误差和左右轮差异）。
+ * 2. 轮距标定（航向数据有效时）：按Key1后用陀螺仪闭环原地旋转TEST_CAL_TURN_DEG，
+ *    按两轮里程差和实际转过的角度计算有效轮距。
+ * 结果立即生效并显示在OLED上（系数×10000，轮距×10），断电后失效，
+ * 需要长期使用时填入MOTOR_WHEEL_CAL_L/R和MOTOR_TRACK_WIDTH_MM。
+ *
+ * @return 0=标定成功，-1=失败（计数异常或没有航向数据）
+ */
+int Test_Wheel_Calibration(void) {
+    int32_t start_L, start_R;
+    float start_heading;
+    bool wheels_ok, track_ok = false;
+    uint8_t x;
+
+    MotorControl_Init();
+
+    // 直线标定
+    OLED_Clear();
+    OLED_ShowString(0, 0, (uint8_t*)"Wheel Cal", 16);
+    x = OLED_ShowString(0, 2, (uint8_t*)"Push ", 16);
+    x = OLED_ShowInt(x, 2, (int32_t)TEST_CAL_DISTANCE_MM, 0, 16);
+    OLED_ShowString(x, 2, (uint8_t*)"mm", 16);
+    OLED_ShowString(0, 4, (uint8_t*)"Key1:Start/Stop", 16);
+    Test_Wait_Key1();
+    start_L = Encoder_GetCount(0);
+    start_R = Encoder_GetCount(1);
+    Test_Wait_Key1();
+    wheels_ok = MotorControl_CalibrateWheels(Encoder_GetCount(0) - start_L, Encoder_GetCount(1) - start_R,
+                                             TEST_CAL_DISTANCE_MM);
+
+    // 轮距标定
+    if (wheels_ok && Heading_IsValid()) {
+        OLED_Clear();
+        OLED_ShowString(0, 0, (uint8_t*)"Track Cal", 16);
+        OLED_ShowString(0, 4, (uint8_t*)"Key1:Spin", 16);
+        Test_Wait_Key1();
+        delay_ms(500);  // 等手离开车体
+
+        start_L = Encoder_GetCount(0);
+        start_R = Encoder_GetCount(1);
+        start_heading = Heading_Get();
+        MotorControl_SetTurnCapture(false);
+        MotorControl_TurnBy(TEST_CAL_TURN_DEG, TEST_CAL_TURN_RATE);
+        while (MotorControl_GetTurnStatus() == MOTOR_TURN_BUSY) {
+            MPU6050_Service();
+            delay_ms(10);
+        }
+        MotorControl_SetTurnCapture(true);
+        delay_ms(200);  // 等车停稳再读里程和航向
+
+        track_ok = MotorControl_CalibrateTrackWidth(Encoder_GetCount(0) - start_L, Encoder_GetCount(1) - start_R,
+                                                    Heading_Get() - start_heading);
+    }
+
+    OLED_Clear();
+    x = OLED_ShowString(0, 0, (uint8_t*)"L:", 16);
+    OLED_ShowInt(x, 0, (int32_t)(g_motorControl.wheel_cal[0] * 10000.0f), 0, 16);
+    x = OLED_ShowString(0, 2, (uint8_t*)"R:", 16);
+    OLED_ShowInt(x, 2, (int32_t)(g_motorControl.wheel_cal[1] * 10000.0f), 0, 16);
+    x = OLED_ShowString(0, 4, (uint8_t*)"W:", 16);
+    OLED_ShowInt(x, 4, (int32_t)(g_motorControl.track_width * 10.0f), 0, 16);
+    OLED_ShowString(0, 6, (uint8_t*)((wheels_ok && track_ok) ? "PASS" : (wheels_ok ? "NO TRACK" : "FAIL")), 16);
+
+    return (wheels_ok && track_ok) ? 0 : -1;
+}
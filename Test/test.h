@@ -7,10 +7,15 @@
 #ifndef TEST_TEST_H_
 #define TEST_TEST_H_
 
+#include <stdint.h>
+
 // 核心测试函数
 void Test_Square_Movement_Hybrid(void);          // 混合模式正方形循迹
 void Test_Square_Movement_Hybrid_With_Laps(int laps); // 指定圈数的混合模式正方形循迹
 void Test_Square_Movement_Hybrid_Key_Control(void); // 通过按键控制圈数的混合模式正方形循迹
 void Test_Line_Sensors_Debug(void);              // 循迹传感器调试显示
+uint32_t Test_OLED_Throughput(void);             // OLED整屏刷新吞吐量测试
+int Test_FastMath_Accuracy(void);                // 快速三角函数精度与耗时测试
+int Test_Wheel_Calibration(void);                // 车轮里程与轮距标定
 
 #endif /* TEST_TEST_H_ */
\ No newline at end of file
@@ -93,5 +93,14 @@ int main(void)
         
         // 循迹传感器调试显示
         // Test_Line_Sensors_Debug();  // 实时显示7路循迹传感器状态
+        
+        // OLED整屏刷新吞吐量测试（比较各传输层的帧率）
+        // Test_OLED_Throughput();
+
+        // 快速三角函数与libm的精度/耗时对比（姿态解算用）
+        // Test_FastMath_Accuracy();
+
+        // 车轮里程与轮距标定（推行已知距离、原地旋转一圈，结果填入motor_control.h）
+        // Test_Wheel_Calibration();
     }
 }
\ No newline at end of file
@@ -4,10 +4,7 @@
 #include "clock.h"
 
 // #include "mpu6050.h"
-#include "oled_software_i2c.h"
-#include "oled_hardware_i2c.h"
-#include "oled_software_spi.h"
-#include "oled_hardware_spi.h"
+#include "oled.h"
 #include "ultrasonic_capture.h"
 #include "ultrasonic_gpio.h"
 #include "bno08x_uart_rvc.h"